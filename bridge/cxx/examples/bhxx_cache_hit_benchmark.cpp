@@ -0,0 +1,66 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+#include <bhxx/bhxx.hpp>
+
+using namespace bhxx;
+
+// Benchmark of the end-to-end cost of a flush that hits the fuse cache and the codegen cache.
+// The arrays are tiny thus the time is dominated by the per-instruction overhead of the bridge and the engine
+// (hashing, cache lookups, and updating the cached blocks) rather than by the computation.
+// Run with BH_<ENGINE>_PROF=true to see the cache hits.
+
+int main(int argc, char *argv[]) {
+    const uint64_t nflushes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100;
+    const uint64_t ninstrs = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+
+    Runtime &runtime = Runtime::instance();
+    BhArray<double> a = ones<double>({10});
+    BhArray<double> b = ones<double>({10});
+    runtime.flush();
+
+    // Every flush records the same instructions, thus only the first flush misses the caches
+    auto body = [&]() {
+        for (uint64_t i = 0; i < ninstrs / 2; ++i) {
+            a += b;
+            b *= 0.5;
+        }
+        runtime.flush();
+        runtime.wait();
+    };
+    body();
+
+    const auto tstart = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < nflushes; ++i) {
+        body();
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - tstart;
+    std::cout << "hit: " << elapsed.count() / nflushes << " us/flush, "
+              << elapsed.count() * 1000 / (nflushes * ninstrs) << " ns/instruction" << std::endl;
+
+    BhArray<double> res({1});
+    add_reduce(res, a, 0);
+    std::cout << "(result: " << res << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include <bhxx/bhxx.hpp>
+
+using namespace bhxx;
+
+// Benchmark of the flush policy of the bridge. Compare runs with BH_BRIDGE_ADAPTIVE_FLUSH=false and
+// BH_BRIDGE_ADAPTIVE_FLUSH=true (and different BH_BRIDGE_FLUSH_THRESHOLD) to see the effect of the policy.
+
+namespace {
+
+// A long chain of element-wise operations on small arrays, which benefits from big flushes
+void fusion_heavy(uint64_t iterations) {
+    BhArray<double> a = ones<double>({1000});
+    BhArray<double> b = ones<double>({1000});
+    for (uint64_t i = 0; i < iterations; ++i) {
+        a = a * 0.999 + b;
+        b = b * 0.5 + a * 0.001;
+    }
+    BhArray<double> res({1});
+    add_reduce(res, a, 0);
+    std::cout << "  result: " << res << std::endl;
+}
+
+// Many big temporary arrays that are alive at the same time, which benefits from small flushes
+void memory_bound(uint64_t iterations, uint64_t nelem) {
+    BhArray<double> acc = zeros<double>({nelem});
+    for (uint64_t i = 0; i < iterations; ++i) {
+        std::vector<BhArray<double> > temps;
+        for (int j = 0; j < 16; ++j) {
+            temps.push_back(acc + static_cast<double>(j));
+        }
+        for (BhArray<double> &t: temps) {
+            acc += t * 1e-6;
+        }
+    }
+    BhArray<double> res({1});
+    add_reduce(res, acc, 0);
+    std::cout << "  result: " << res << std::endl;
+}
+
+template <typename F>
+void run(const std::string &name, F func) {
+    Runtime &runtime = Runtime::instance();
+    const uint64_t flushes = runtime.getFlushCount();
+    const auto tstart = std::chrono::steady_clock::now();
+    func();
+    runtime.flush();
+    runtime.wait();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - tstart;
+    std::cout << name << ": " << elapsed.count() << "s, " << runtime.getFlushCount() - flushes << " flushes"
+              << std::endl;
+}
+
+} // Unnamed namespace
+
+int main(int argc, char *argv[]) {
+    const uint64_t scale = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1;
+    run("fusion heavy", [scale]() { fusion_heavy(scale * 20000); });
+    run("memory bound", [scale]() { memory_bound(scale * 10, 1 << 24); });
+    return 0;
+}
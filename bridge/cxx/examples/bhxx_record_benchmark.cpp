@@ -0,0 +1,64 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include <bhxx/bhxx.hpp>
+
+using namespace bhxx;
+
+// Benchmark of the per-instruction overhead of recording and copying instruction lists,
+// which every flush pays in the bridge and again in the components (e.g. `BhIR`, `simplify_instr_list()`)
+
+int main(int argc, char *argv[]) {
+    const uint64_t nrepeats = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    const uint64_t ninstrs = 1000;
+
+    BhArray<double> a({100, 100});
+    BhArray<double> b({100, 100});
+    BhArray<double> c({100, 100});
+    std::vector<bh_instruction> instr_list;
+    uint64_t checksum = 0;
+
+    auto tstart = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < nrepeats; ++i) {
+        instr_list.clear();
+        for (uint64_t j = 0; j < ninstrs; ++j) {
+            BhInstruction instr(BH_ADD);
+            instr.appendOperand(c, a, b);
+            instr_list.push_back(std::move(instr));
+        }
+        checksum += instr_list.size();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - tstart;
+    std::cout << "record: " << elapsed.count() / (nrepeats * ninstrs) << " ns/instruction" << std::endl;
+
+    tstart = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < nrepeats; ++i) {
+        std::vector<bh_instruction> copy(instr_list);
+        checksum += copy.size();
+    }
+    elapsed = std::chrono::steady_clock::now() - tstart;
+    std::cout << "copy:   " << elapsed.count() / (nrepeats * ninstrs) << " ns/instruction" << std::endl;
+    std::cout << "(" << checksum << " instructions)" << std::endl;
+    return 0;
+}
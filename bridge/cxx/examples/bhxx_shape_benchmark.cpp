@@ -0,0 +1,50 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+#include <bhxx/bhxx.hpp>
+
+using namespace bhxx;
+
+// Benchmark of a computation that runs on many different array sizes. Compare runs with
+// BH_OPENMP_SHAPE_AS_VAR=false and BH_OPENMP_SHAPE_AS_VAR=true (and BH_OPENMP_PROF=true to see the cache hits).
+// Without shape_as_var, every size compiles its own kernels.
+
+int main(int argc, char *argv[]) {
+    const uint64_t nsizes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100;
+
+    Runtime &runtime = Runtime::instance();
+    const auto tstart = std::chrono::steady_clock::now();
+    double total = 0;
+    for (uint64_t n = 1000; n < 1000 + nsizes; ++n) {
+        BhArray<double> a = ones<double>({n, 4});
+        BhArray<double> b = a * 2.0 + 1.0;
+        BhArray<double> res({1});
+        add_reduce(res, b.reshape({n * 4}), 0);
+        runtime.flush();
+        total += res.vec()[0];
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - tstart;
+    std::cout << nsizes << " sizes: " << elapsed.count() << "s (result: " << total << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+#include <bhxx/bhxx.hpp>
+
+using namespace bhxx;
+
+// Benchmark of 3-D and 4-D stencils on every other element of the innermost axis, which makes all views strided.
+// Compare runs with BH_OPENMP_INDEX_STRENGTH_REDUCE=false and BH_OPENMP_INDEX_STRENGTH_REDUCE=true.
+
+namespace {
+// Return the view of the interior of `grid` shifted by `shift` elements along each axis where the innermost axis
+// only covers every other element
+BhArray<double> interior(const BhArray<double> &grid, const std::vector<int64_t> &shift) {
+    Shape shape(grid.shape().size());
+    Stride stride(grid.shape().size());
+    uint64_t offset = grid.offset();
+    for (size_t i = 0; i < shape.size(); ++i) {
+        const bool innermost = i + 1 == shape.size();
+        shape[i] = innermost ? (grid.shape()[i] - 2) / 2 : grid.shape()[i] - 2;
+        stride[i] = innermost ? grid.stride()[i] * 2 : grid.stride()[i];
+        offset += (1 + shift[i]) * grid.stride()[i];
+    }
+    return BhArray<double>(grid.base(), shape, stride, offset);
+}
+
+// Run `iterations` Jacobi sweeps of the stencil that averages the two neighbours along each axis of `grid`
+// and return the number of updated elements per second
+double run(BhArray<double> &grid, uint64_t iterations) {
+    const size_t ndim = grid.shape().size();
+    BhArray<double> center = interior(grid, std::vector<int64_t>(ndim, 0));
+    const uint64_t nelem = center.shape().prod();
+
+    const auto tstart = std::chrono::steady_clock::now();
+    for (uint64_t it = 0; it < iterations; ++it) {
+        BhArray<double> sum = center * 0.0;
+        for (size_t i = 0; i < ndim; ++i) {
+            std::vector<int64_t> shift(ndim, 0);
+            shift[i] = -1;
+            sum += interior(grid, shift);
+            shift[i] = 1;
+            sum += interior(grid, shift);
+        }
+        identity(center, sum / (2.0 * ndim));
+        Runtime::instance().flush();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - tstart;
+    return nelem * iterations / elapsed.count();
+}
+}
+
+int main(int argc, char *argv[]) {
+    const uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20;
+    {
+        BhArray<double> grid = ones<double>({130, 130, 258});
+        std::cout << "3-D stencil: " << run(grid, iterations) / 1e6 << " M elements/s" << std::endl;
+    }
+    {
+        BhArray<double> grid = ones<double>({34, 34, 34, 66});
+        std::cout << "4-D stencil: " << run(grid, iterations) / 1e6 << " M elements/s" << std::endl;
+    }
+    return 0;
+}
@@ -102,7 +102,9 @@ public:
         }
     }
 
-    /** Return a `bh_view` of the array */
+    /** Return a `bh_view` of the array
+     *  NB: the view doesn't include the slides of the array (see `BhInstruction::appendOperand()`)
+     */
     bh_view getBhView() const {
         bh_view view;
         assert(_base);
@@ -117,7 +119,6 @@ public:
             view.shape = BhIntVec(shape().begin(), shape().end());
             view.stride = BhIntVec(_stride.begin(), _stride.end());;
         }
-        view.slides = _slides;
         return view;
     }
 
@@ -299,8 +300,9 @@ public:
     bool isContiguous() const;
 
     /** Is the data referenced by this view's base array already
-     *  allocated, i.e. initialised */
-    bool isDataInitialised() const { return _base->getDataPtr() != nullptr; }
+     *  allocated, i.e. initialised
+     *  NB: waits for the executing flush, which might allocate the data */
+    bool isDataInitialised() const;
 
     /** Obtain the data pointer of the array, not taking ownership of any kind.
      *
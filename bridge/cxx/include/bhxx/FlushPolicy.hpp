@@ -0,0 +1,108 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <bohrium/bh_instruction.hpp>
+#include <bohrium/bh_config_parser.hpp>
+
+namespace bhxx {
+
+/** The feedback of an executed flush */
+struct FlushFeedback {
+    // Number of instructions in the flush
+    uint64_t num_instrs = 0;
+    // Was the flush triggered by the instruction threshold or by the memory limit (as opposed to e.g. a sync)?
+    bool by_threshold = false;
+    bool by_memory = false;
+    // Wall-clock time of the execution in seconds
+    double seconds = 0;
+    // Fuse cache lookups and misses of the flush or -1 when the component stack doesn't report them
+    int64_t fuse_cache_lookups = -1;
+    int64_t fuse_cache_misses = -1;
+};
+
+/** Decides when the bridge flushes the instructions it has recorded.
+ *
+ *  A flush is triggered when the number of instructions reaches the threshold or when the arrays created since
+ *  the last flush, and still live when an array is freed, exceed the memory limit (disabled by default). Those
+ *  are the arrays the flush has to allocate, thus the limit bounds the temporary memory of a flush.
+ *  When adaptive, the threshold doubles while the fuse cache of the component stack hits, since bigger flushes
+ *  give more room for fusion. It stops growing when the execution time per instruction got worse with the
+ *  last increase, and shrinks to the size of a flush that hit the memory limit.
+ */
+class FlushPolicy {
+public:
+    /// Read the policy from the bridge section of `config`
+    explicit FlushPolicy(const bohrium::ConfigParser &config);
+
+    /// Account the just recorded instruction `instr` and return true when the bridge should flush
+    bool recorded(const bh_instruction &instr);
+
+    /// Return true when the recorded instructions exceed the memory limit
+    bool memoryLimitReached() const {
+        return _memory_limit > 0 and _live_bytes > _memory_limit;
+    }
+
+    /// Forget the recorded instructions, which must be called on every flush
+    void flushed();
+
+    /// Adapt the threshold to the feedback of an executed flush
+    void feedback(const FlushFeedback &feedback);
+
+    /// Is the threshold adaptive thus `feedback()` should be called?
+    bool adaptive() const {
+        return _adaptive;
+    }
+
+    /// The current instruction threshold
+    uint64_t threshold() const {
+        return _threshold;
+    }
+
+private:
+    const bool _adaptive;
+    uint64_t _threshold;
+    const uint64_t _threshold_min;
+    // The threshold doesn't grow beyond this, which is lowered when a growth made execution slower
+    uint64_t _threshold_cap;
+    // The fuse cache hit rate that allows the threshold to grow
+    const double _grow_hit_rate;
+    uint64_t _memory_limit;
+
+    // Number of instructions recorded since the last flush
+    uint64_t _num_instrs = 0;
+    // The arrays we have seen and not seen freed, which we never inspect again since a flush might use them
+    std::unordered_set<const bh_base *> _seen_bases;
+    // The arrays created since the last flush and their size
+    std::unordered_map<const bh_base *, uint64_t> _new_bases;
+    // The bytes of `_new_bases`
+    uint64_t _live_bytes = 0;
+
+    // The execution time per instruction and the threshold of the last flush that hit the fuse cache
+    // (negative when unknown)
+    double _last_cost = -1;
+    uint64_t _last_threshold = 0;
+};
+
+} // namespace bhxx
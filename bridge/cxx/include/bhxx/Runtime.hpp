@@ -21,8 +21,13 @@ If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 #include "BhInstruction.hpp"
+#include "FlushPolicy.hpp"
 #include <bohrium/bh_component.hpp>
 
 namespace bhxx {
@@ -31,15 +36,22 @@ namespace bhxx {
  *  Encapsulation of communication with Bohrium runtime.
  *  Implemented as a Singleton.
  *
+ *  When `async_flush` is enabled in the config, a flush hands the instructions to an executor thread and returns
+ *  right away thus the next batch of instructions can be recorded while the previous batch executes. At most one
+ *  batch executes at a time, which means that a flush blocks until the previous flush has finished.
+ *  All access to array data and to the component stack (e.g. `getMemoryPointer()` and `message()`) blocks until
+ *  the executing batch has finished (see `wait()`).
+ *
+ *  When the bridge flushes on its own is decided by a `FlushPolicy`, which adapts to the feedback of the
+ *  executed flushes.
+ *
  *  \note  Not thread-safe.
  */
 class Runtime {
 public:
     Runtime();
 
-    ~Runtime() {
-        flush();
-    }
+    ~Runtime();
 
     /// Get the singleton instance of the Runtime class
     static Runtime &instance() {
@@ -82,6 +94,11 @@ public:
     /// Flag array to be sync'ed after the next flush
     void sync(const std::shared_ptr<BhBase> &base_ptr);
 
+    /** Block until the previous flush has finished executing, which is a no-op without `async_flush`.
+     *  An exception thrown by the execution is rethrown here.
+     */
+    void wait();
+
     /** Changes the offset and shape of a view between the iterations of a `do_while` loop.
      * This is the underlying functionality behind using iterators.
      *
@@ -112,6 +129,11 @@ public:
         view_ptr->slides().resets[dim] = std::make_pair(reset_it, 0);
     }
 
+    /** Return a copy of `slide` for a view of an enqueued instruction, which lives until the flushed
+     *  instructions have executed (see `bh_view::slides`)
+     */
+    bh_slide *newSlide(const bh_slide &slide);
+
     /// Send and receive a message through the component stack
     std::string message(const std::string &msg);
 
@@ -149,6 +171,7 @@ public:
     void memCopy(BhArray<T> &src, BhArray<T> &dst, const std::string &param) {
         bh_view _src = src.getBhView();
         bh_view _dst = dst.getBhView();
+        wait();
         runtime.memCopy(_src, _dst, param);
     }
 
@@ -197,12 +220,37 @@ private:
     void freeMemory(BhArray<T> &ary);
     //@}
 
+    /// Send enqueued instructions to Bohrium (see `flushAndRepeat()`). `by_policy` tells whether the flush
+    /// was triggered by the flush policy as opposed to the user
+    void _flush(uint64_t nrepeats, const std::shared_ptr<BhBase> &base_ptr, bool by_policy = false);
+
+    // A flushed batch of instructions and the objects that must live until it has executed
+    struct FlushJob {
+        std::unique_ptr<BhIR> bhir;
+        std::vector<std::unique_ptr<BhBase> > bases_for_deletion;
+        std::shared_ptr<BhBase> repeat_condition;
+        FlushFeedback feedback;
+    };
+
+    /// Execute `job` and complete its feedback
+    void execute(FlushJob &job);
+
+    /// The loop of the executor thread, which executes `executing` when set
+    void executorLoop();
+
     // The lazy evaluated instructions
     std::vector<bh_instruction> instr_list;
 
+    // The cleared instruction list of the flush `executor` executed last, which `instr_list` reuses thus recording
+    // doesn't allocate. Without `async_flush`, `instr_list` reuses the list of the executed flush directly.
+    std::vector<bh_instruction> spare_instr_list;
+
     // The base arrays to sync when flushing
     std::set<bh_base *> syncs;
 
+    // The slides of the views in `instr_list`
+    std::vector<std::shared_ptr<bh_slide> > slides;
+
     // Unique pointers to base objects, which are to be
     // purged after the next flush
     std::vector<std::unique_ptr<BhBase> > bases_for_deletion;
@@ -221,6 +269,25 @@ private:
 
     // Number of calls to flush
     uint64_t _flush_count = 0;
+
+    // Decides when to flush
+    FlushPolicy flush_policy;
+    // The fuse cache statistics of the component stack at the end of the last flush
+    int64_t fuse_cache_lookups = 0;
+    int64_t fuse_cache_misses = 0;
+
+    // Execute flushes on `executor` (see the class description)
+    const bool async_flush;
+    std::thread executor;
+    std::mutex executor_mutex;
+    std::condition_variable executor_cond;
+    // The flush that `executor` is executing or nullptr when it is idle
+    std::unique_ptr<FlushJob> executing;
+    // The exception thrown by the executing flush, which `wait()` rethrows
+    std::exception_ptr executor_error;
+    bool executor_stop = false;
+    // The feedback of the flush `executor` executed last, which hasn't been given to `flush_policy` yet
+    std::unique_ptr<FlushFeedback> executed_feedback;
 };
 
 //
@@ -252,6 +319,7 @@ void Runtime::enqueueExtmethod(const std::string &name, BhArray<T> &out, BhArray
     } else {
         // Add it and tell rest of Bohrium about this new extmethod
         opcode = extmethod_next_opcode_id++;
+        wait();
         runtime.extmethod(name.c_str(), opcode);
         extmethods.insert(std::pair<std::string, bh_opcode>(name, opcode));
     }
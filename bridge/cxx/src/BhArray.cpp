@@ -47,6 +47,7 @@ const T *BhArray<T>::data(bool flush) const {
         Runtime::instance().sync(_base);
         Runtime::instance().flush();
     }
+    Runtime::instance().wait();
     auto ret = static_cast<T *>(_base->getDataPtr());
     if (ret == nullptr) {
         return nullptr;
@@ -55,6 +56,12 @@ const T *BhArray<T>::data(bool flush) const {
     }
 }
 
+template<typename T>
+bool BhArray<T>::isDataInitialised() const {
+    Runtime::instance().wait();
+    return _base->getDataPtr() != nullptr;
+}
+
 template<typename T>
 bool BhArray<T>::isContiguous() const {
     assert(shape().size() == _stride.size());
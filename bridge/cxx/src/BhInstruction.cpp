@@ -19,6 +19,7 @@ If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <bhxx/BhInstruction.hpp>
+#include <bhxx/Runtime.hpp>
 
 namespace bhxx {
 
@@ -65,7 +66,11 @@ void BhInstruction::appendOperand(const BhArray<T> &ary) {
                 "BH_FREE cannot be used as an instruction on arrays in the bhxx interface. "
                 "Use Runtime::instance().enqueue(BH_FREE,array) instead.");
     }
-    operand.push_back(ary.getBhView());
+    bh_view view = ary.getBhView();
+    if (not ary.slides().dims.empty()) {
+        view.slides = Runtime::instance().newSlide(ary.slides());
+    }
+    operand.push_back(view);
 }
 
 template<typename T>
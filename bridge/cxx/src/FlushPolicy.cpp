@@ -0,0 +1,121 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <bhxx/FlushPolicy.hpp>
+#include <bohrium/bh_main_memory.hpp>
+
+using namespace std;
+
+namespace bhxx {
+
+FlushPolicy::FlushPolicy(const bohrium::ConfigParser &config)
+        : _adaptive(config.defaultGet<bool>("adaptive_flush", false)),
+          _threshold(config.defaultGet<uint64_t>("flush_threshold", 1000)),
+          _threshold_min(config.defaultGet<uint64_t>("flush_threshold_min", 100)),
+          _threshold_cap(config.defaultGet<uint64_t>("flush_threshold_max", 50000)),
+          _grow_hit_rate(config.defaultGet<double>("flush_grow_hit_rate", 0.9)) {
+    if (_threshold_min < 1 or _threshold_min > _threshold_cap) {
+        throw std::runtime_error("config: `flush_threshold_min` must be between 1 and `flush_threshold_max`");
+    }
+    if (_threshold < 1) {
+        throw std::runtime_error("config: `flush_threshold` must be positive");
+    }
+    if (_adaptive) {
+        _threshold = std::min(std::max(_threshold, _threshold_min), _threshold_cap);
+    }
+    const auto percent = config.defaultGet<uint64_t>("flush_temp_memory", 0);
+    if (percent > 100) {
+        throw std::runtime_error("config: `flush_temp_memory` must be a percentage of the main memory");
+    }
+    _memory_limit = bh_main_memory_total() / 100 * percent;
+}
+
+bool FlushPolicy::recorded(const bh_instruction &instr) {
+    ++_num_instrs;
+    if (instr.opcode == BH_FREE) {
+        const bh_base *base = instr.operand[0].base;
+        auto it = _new_bases.find(base);
+        if (it != _new_bases.end()) {
+            _live_bytes -= it->second;
+            _new_bases.erase(it);
+        }
+        _seen_bases.erase(base);
+    } else if (_memory_limit > 0) {
+        for (const bh_view &view: instr.operand) {
+            if (view.isConstant() or not _seen_bases.insert(view.base).second) {
+                continue;
+            }
+            // NB: we only read the data pointer the first time we see an array. Every flush is recorded here
+            //     thus no flush, including an executing async flush, has used the array yet. Arrays with data,
+            //     such as arrays copied from NumPy, are not allocated by the flush.
+            if (view.base->getDataPtr() == nullptr) {
+                const auto nbytes = static_cast<uint64_t>(view.base->nbytes());
+                _new_bases.insert(make_pair(view.base, nbytes));
+                _live_bytes += nbytes;
+            }
+        }
+    }
+    // NB: the memory limit is only checked when an array is freed, which ends an expression in the bridges. At that
+    //     point, the temporary arrays of the expression are freed thus they aren't counted.
+    return _num_instrs >= _threshold or (instr.opcode == BH_FREE and memoryLimitReached());
+}
+
+void FlushPolicy::flushed() {
+    _new_bases.clear();
+    _live_bytes = 0;
+    _num_instrs = 0;
+}
+
+void FlushPolicy::feedback(const FlushFeedback &feedback) {
+    if (not _adaptive or feedback.num_instrs == 0) {
+        return;
+    }
+    if (feedback.by_memory) {
+        // Flushes of this size need too much temporary memory
+        _threshold = std::max(_threshold_min, std::min(_threshold, feedback.num_instrs));
+        _last_cost = -1;
+        return;
+    }
+    // Only full flushes without compilation tell us something about the threshold
+    if (not feedback.by_threshold or feedback.fuse_cache_lookups <= 0) {
+        return;
+    }
+    const double hit_rate = static_cast<double>(feedback.fuse_cache_lookups - feedback.fuse_cache_misses) /
+                            feedback.fuse_cache_lookups;
+    if (hit_rate < _grow_hit_rate) {
+        return;
+    }
+    const double cost = feedback.seconds / feedback.num_instrs;
+    const uint64_t threshold = _threshold;
+    if (_last_cost >= 0 and _threshold > _last_threshold and cost > _last_cost * 1.1) {
+        // The last growth made execution slower thus we go back and stay there
+        _threshold_cap = std::max(_threshold_min, _threshold / 2);
+        _threshold = _threshold_cap;
+    } else {
+        _threshold = std::min(_threshold * 2, _threshold_cap);
+    }
+    _last_cost = cost;
+    _last_threshold = threshold;
+}
+
+} // namespace bhxx
@@ -20,6 +20,7 @@ If not, see <http://www.gnu.org/licenses/>.
 
 #include <bhxx/Runtime.hpp>
 #include <iterator>
+#include <chrono>
 
 using namespace std;
 
@@ -28,16 +29,80 @@ namespace bhxx {
 Runtime::Runtime()
       : config(-1),                                // stack level -1 is the bridge
         runtime(config.getChildLibraryPath(), 0),  // and child is stack level 0
-        extmethod_next_opcode_id(BH_MAX_OPCODE_ID + 1) {}
+        extmethod_next_opcode_id(BH_MAX_OPCODE_ID + 1),
+        flush_policy(config),
+        async_flush(config.defaultGet<bool>("async_flush", false)) {
+    if (async_flush) {
+        executor = std::thread(&Runtime::executorLoop, this);
+    }
+}
+
+Runtime::~Runtime() {
+    try {
+        flush();
+        wait();
+    } catch (const std::exception &e) {
+        cerr << "[BHXX] flush at exit failed: " << e.what() << endl;
+    }
+    if (async_flush) {
+        {
+            std::lock_guard<std::mutex> lock(executor_mutex);
+            executor_stop = true;
+        }
+        executor_cond.notify_all();
+        executor.join();
+    }
+}
+
+void Runtime::executorLoop() {
+    std::unique_lock<std::mutex> lock(executor_mutex);
+    while (true) {
+        executor_cond.wait(lock, [this]() { return executing or executor_stop; });
+        if (not executing) {
+            return;
+        }
+        // NB: only this thread changes `executing` while it is set thus we can use it without the lock
+        lock.unlock();
+        try {
+            execute(*executing);
+        } catch (...) {
+            executor_error = std::current_exception();
+        }
+        // Purge the bases scheduled for deletion
+        executing->bases_for_deletion.clear();
+        lock.lock();
+        spare_instr_list = std::move(executing->bhir->instr_list);
+        spare_instr_list.clear();
+        executed_feedback.reset(new FlushFeedback(executing->feedback));
+        executing.reset();
+        executor_cond.notify_all();
+    }
+}
+
+void Runtime::wait() {
+    if (not async_flush) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(executor_mutex);
+    executor_cond.wait(lock, [this]() { return not executing; });
+    if (executed_feedback) {
+        flush_policy.feedback(*executed_feedback);
+        executed_feedback.reset();
+    }
+    if (executor_error) {
+        std::exception_ptr error = executor_error;
+        executor_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
 
 void Runtime::enqueue(BhInstruction instr) {
     instr_list.push_back(std::move(instr));
 
-    // We hard-code a kernel size threshold here.
     // NB: we HAVE to include the just enqueued instruction since it might be a BH_FREE,
     // which clears `bases_for_deletion`.
-    if (instr_list.size() >= 1000) {
-        flush();
+    if (flush_policy.recorded(instr_list.back())) {
+        _flush(1, nullptr, true);
     }
 }
 
@@ -60,6 +125,8 @@ void Runtime::enqueueDeletion(std::unique_ptr<BhBase> base_ptr) {
     if (!base_ptr->ownMemory()) {
         // Externally managed
         // => set it to null to avoid deletion by Bohrium
+        // NB: the executing flush might use the memory
+        wait();
         base_ptr->resetDataPtr();
     }
 
@@ -69,39 +136,83 @@ void Runtime::enqueueDeletion(std::unique_ptr<BhBase> base_ptr) {
     enqueue(std::move(instr));
 }
 
-namespace {
-// Help function to handle flushing
-void _flush(uint64_t nrepeats, const std::shared_ptr<BhBase> &base_ptr,
-            std::vector<bh_instruction> &instr_list,
-            std::set<bh_base *> &syncs,
-            bohrium::component::ComponentFace &runtime,
-            std::vector<std::unique_ptr<BhBase> > &bases_for_deletion,
-            uint64_t &_flush_count) {
+void Runtime::execute(FlushJob &job) {
+    const auto tstart = std::chrono::steady_clock::now();
+    runtime.execute(job.bhir.get());
+    job.feedback.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tstart).count();
 
-    if (not base_ptr) { // The pointer isn't initiated
-        BhIR bhir(std::move(instr_list), std::move(syncs), nrepeats);
-        runtime.execute(&bhir);
-    } else {
-        BhIR bhir(std::move(instr_list), std::move(syncs), nrepeats, &(*base_ptr));
-        runtime.execute(&bhir);
+    if (flush_policy.adaptive()) {
+        // Each engine in the stack replies with a "<lookups> <misses>" pair
+        std::istringstream reply(runtime.message("fuse_cache_stat"));
+        int64_t lookups = 0, misses = 0, l, m;
+        bool replied = false;
+        while (reply >> l >> m) {
+            lookups += l;
+            misses += m;
+            replied = true;
+        }
+        // NB: the statistics of an engine are reset by "statistic_enable_and_reset"
+        if (replied and lookups >= fuse_cache_lookups and misses >= fuse_cache_misses) {
+            job.feedback.fuse_cache_lookups = lookups - fuse_cache_lookups;
+            job.feedback.fuse_cache_misses = misses - fuse_cache_misses;
+        }
+        fuse_cache_lookups = lookups;
+        fuse_cache_misses = misses;
     }
+}
+
+void Runtime::_flush(uint64_t nrepeats, const std::shared_ptr<BhBase> &base_ptr, bool by_policy) {
+    std::unique_ptr<FlushJob> job(new FlushJob());
+    job->feedback.num_instrs = instr_list.size();
+    job->feedback.by_memory = by_policy and flush_policy.memoryLimitReached();
+    job->feedback.by_threshold = by_policy and not job->feedback.by_memory;
+    job->bhir.reset(new BhIR(std::move(instr_list), std::move(syncs), nrepeats,
+                             base_ptr ? &(*base_ptr) : nullptr));
+    job->bhir->_slides = std::move(slides);
+    job->bases_for_deletion = std::move(bases_for_deletion);
+    job->repeat_condition = base_ptr;
 
     instr_list.clear(); // Notice, it is legal to clear a moved collection.
     syncs.clear();
-
-    // Purge the bases we have scheduled for deletion:
+    slides.clear();
     bases_for_deletion.clear();
+    flush_policy.flushed();
     ++_flush_count;
-}
+
+    if (async_flush) {
+        // Double buffering: we wait for the previous flush before handing over this one
+        wait();
+        // NB: the executor writes `spare_instr_list` thus we must take it before handing over this flush
+        instr_list.swap(spare_instr_list);
+        {
+            std::lock_guard<std::mutex> lock(executor_mutex);
+            executing = std::move(job);
+        }
+        executor_cond.notify_all();
+    } else {
+        execute(*job);
+        // Purge the bases we have scheduled for deletion:
+        job->bases_for_deletion.clear();
+        flush_policy.feedback(job->feedback);
+        if (instr_list.empty()) {
+            instr_list = std::move(job->bhir->instr_list);
+            instr_list.clear();
+        }
+    }
 }
 
 void Runtime::flush() {
     std::shared_ptr<BhBase> dummy;
-    _flush(1, dummy, instr_list, syncs, runtime, bases_for_deletion, _flush_count);
+    _flush(1, dummy);
 }
 
 void Runtime::flushAndRepeat(uint64_t nrepeats, const std::shared_ptr<BhBase> &base_ptr) {
-    _flush(nrepeats, base_ptr, instr_list, syncs, runtime, bases_for_deletion, _flush_count);
+    _flush(nrepeats, base_ptr);
+}
+
+bh_slide *Runtime::newSlide(const bh_slide &slide) {
+    slides.emplace_back(new bh_slide(slide));
+    return slides.back().get();
 }
 
 void Runtime::sync(const std::shared_ptr<BhBase> &base_ptr) {
@@ -109,22 +220,27 @@ void Runtime::sync(const std::shared_ptr<BhBase> &base_ptr) {
 }
 
 std::string Runtime::message(const std::string &msg) {
+    wait();
     return runtime.message(msg);
 }
 
 void* Runtime::getMemoryPointer(std::shared_ptr<BhBase> &base, bool copy2host, bool force_alloc, bool nullify) {
+    wait();
     return runtime.getMemoryPointer(*base, copy2host, force_alloc, nullify);
 }
 
 void Runtime::setMemoryPointer(std::shared_ptr<BhBase> &base, bool host_ptr, void *mem) {
+    wait();
     return runtime.setMemoryPointer(base.get(), host_ptr, mem);
 }
 
 void* Runtime::getDeviceContext() {
+    wait();
     return runtime.getDeviceContext();
 }
 
 void Runtime::setDeviceContext(void *device_context) {
+    wait();
     runtime.setDeviceContext(device_context);
 }
 
@@ -134,6 +250,7 @@ std::string Runtime::userKernel(const std::string &kernel, std::vector<BhArrayUn
     for (BhArrayUnTypedCore* op: operand_list) {
         ops.push_back(op->getBhView());
     }
+    wait();
     return runtime.userKernel(kernel, ops, compile_cmd, tag, param);
 }
 
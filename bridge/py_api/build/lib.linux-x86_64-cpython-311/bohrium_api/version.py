@@ -0,0 +1,2 @@
+__version__ = "0.11.0"
+__version_info__ = (0, 11, 0, 0)
@@ -19,6 +19,7 @@ If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <string>
+#include <sstream>
 #include <algorithm>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/ini_parser.hpp>
@@ -219,6 +220,18 @@ vector<boost::filesystem::path> ConfigParser::getListOfPaths(const std::string &
     return ret;
 }
 
+string ConfigParser::getSectionAsString() const {
+    stringstream ss;
+    ss << "[" << _default_section << "]";
+    const auto section = _config.get_child_optional(_default_section);
+    if (section) {
+        for (const auto &option: *section) {
+            ss << option.first << "=" << lookup(_default_section, option.first) << ";";
+        }
+    }
+    return ss.str();
+}
+
 string ConfigParser::getChildLibraryPath() const {
     // Do we have a child?
     if (static_cast<int>(_stack_list.size()) <= stack_level + 1) {
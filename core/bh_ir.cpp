@@ -53,6 +53,25 @@ BhIR::BhIR(const std::vector<char> &serialized_archive, std::map<const bh_base*,
     // Load the instruction list
     ia >> instr_list;
 
+    // Load the slides and update the slide pointers of the views, which are remote slide pointers
+    {
+        vector<size_t> slide_ids;
+        vector<bh_slide> slides;
+        ia >> slide_ids >> slides;
+        map<size_t, bh_slide *> remote2local_slides;
+        for (size_t i = 0; i < slides.size(); ++i) {
+            _slides.emplace_back(new bh_slide(std::move(slides[i])));
+            remote2local_slides[slide_ids.at(i)] = _slides.back().get();
+        }
+        for (bh_instruction &instr: instr_list) {
+            for (bh_view &v: instr.getViews()) {
+                if (v.slides != nullptr) {
+                    v.slides = remote2local_slides.at(reinterpret_cast<size_t>(v.slides));
+                }
+            }
+        }
+    }
+
     // Load the set of syncs
     {
         vector<size_t> base_as_int;
@@ -144,6 +163,22 @@ std::vector<char> BhIR::writeSerializedArchive(set<bh_base *> &known_base_arrays
     // Write the instruction list
     oa << instr_list;
 
+    // Write the slides of the views, which the views refer to by their address
+    {
+        vector<size_t> slide_ids;
+        vector<bh_slide> slides;
+        set<const bh_slide *> written;
+        for (bh_instruction &instr: instr_list) {
+            for (const bh_view &v: instr.getViews()) {
+                if (v.slides != nullptr and written.insert(v.slides).second) {
+                    slide_ids.push_back(reinterpret_cast<size_t>(v.slides));
+                    slides.push_back(*v.slides);
+                }
+            }
+        }
+        oa << slide_ids << slides;
+    }
+
     vector<size_t> base_as_int;
     for(bh_base *base: _syncs) {
         base_as_int.push_back(reinterpret_cast<size_t>(base));
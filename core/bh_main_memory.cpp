@@ -18,13 +18,27 @@ GNU Lesser General Public License along with Bohrium.
 If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <limits>
 #include <bohrium/bh_main_memory.hpp>
 #include <bohrium/bh_malloc_cache.hpp>
 #include <bohrium/jitk/subprocess.hpp>
 #include <sys/mman.h>
 #include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <boost/regex.hpp>
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
 #if defined(__APPLE__) || defined(__MACOSX)
 #include <sys/sysctl.h>
 #else
@@ -81,47 +95,545 @@ int64_t bh_main_memory_unused() {
 }
 
 
+NumaPolicy bh_numa_policy_from_string(const std::string &name) {
+    if (name == "none") {
+        return NumaPolicy::NONE;
+    } else if (name == "interleave") {
+        return NumaPolicy::INTERLEAVE;
+    } else if (name == "first_touch") {
+        return NumaPolicy::FIRST_TOUCH;
+    } else if (name == "local") {
+        return NumaPolicy::LOCAL;
+    }
+    throw std::runtime_error("config: `numa_policy` must be 'none', 'interleave', 'first_touch', or 'local'");
+}
+
+PagePolicy bh_page_policy_from_string(const std::string &name) {
+    if (name == "none") {
+        return PagePolicy::NONE;
+    } else if (name == "thp") {
+        return PagePolicy::THP;
+    } else if (name == "hugetlb") {
+        return PagePolicy::HUGETLB;
+    }
+    throw std::runtime_error("config: `page_policy` must be 'none', 'thp', or 'hugetlb'");
+}
+
+PrefaultPolicy bh_prefault_policy_from_string(const std::string &name) {
+    if (name == "none") {
+        return PrefaultPolicy::NONE;
+    } else if (name == "populate") {
+        return PrefaultPolicy::POPULATE;
+    } else if (name == "parallel") {
+        return PrefaultPolicy::PARALLEL;
+    }
+    throw std::runtime_error("config: `prefault` must be 'none', 'populate', or 'parallel'");
+}
+
+int bh_numa_num_nodes() {
+    static int ret = 0;
+    if (ret == 0) {
+        while (access(("/sys/devices/system/node/node" + std::to_string(ret)).c_str(), F_OK) == 0) {
+            ++ret;
+        }
+        ret = std::max(ret, 1);
+    }
+    return ret;
+}
+
 namespace {
-// Allocate page-size aligned main memory.
-void *main_mem_malloc(uint64_t nbytes) {
+// The NUMA policy (see `bh_set_numa_policy()`)
+NumaPolicy numa_policy = NumaPolicy::NONE;
+uint64_t numa_threshold = 0;
+std::function<void(void *, uint64_t)> numa_first_touch;
+
+// The page and prefault policies (see `bh_set_page_policy()`)
+PagePolicy page_policy = PagePolicy::NONE;
+uint64_t page_threshold = 0;
+PrefaultPolicy prefault_policy = PrefaultPolicy::NONE;
+uint64_t prefault_threshold = 0;
+std::function<void(void *, uint64_t)> prefault_parallel_touch;
+
+// Main memory is allocated using `mmap()` thus cached segments can be split and unmapped at huge page granularity
+constexpr uint64_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// The malloc cache tag of an allocation is its NUMA placement and page policy. The lower byte is the NUMA
+// placement: zero is the default placement and with the LOCAL policy, it is `NUMA_TAG_NODE` plus the node.
+// The page policy is the tag shifted by `PAGE_TAG_SHIFT`.
+constexpr int NUMA_TAG_INTERLEAVE = 1;
+constexpr int NUMA_TAG_FIRST_TOUCH = 2;
+constexpr int NUMA_TAG_NODE = 3;
+constexpr int NUMA_TAG_MASK = 0xff;
+constexpr int PAGE_TAG_SHIFT = 8;
+
+// The memory policies of `mbind()` (see <numaif.h>, which we don't require)
+constexpr int MPOL_PREFERRED_MODE = 1;
+constexpr int MPOL_INTERLEAVE_MODE = 3;
+
+// Return the NUMA node of the calling thread
+int current_numa_node() {
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned int cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return static_cast<int>(node);
+    }
+#endif
+    return 0;
+}
+
+// Return the malloc cache tag of an allocation of `nbytes`
+int numa_tag(uint64_t nbytes) {
+    if (numa_policy == NumaPolicy::NONE or nbytes < numa_threshold) {
+        return 0;
+    }
+    switch (numa_policy) {
+        case NumaPolicy::INTERLEAVE:
+            return NUMA_TAG_INTERLEAVE;
+        case NumaPolicy::FIRST_TOUCH:
+            return NUMA_TAG_FIRST_TOUCH;
+        default:
+            return NUMA_TAG_NODE + current_numa_node();
+    }
+}
+
+// Return the malloc cache tag of an allocation of `nbytes`, which is the NUMA tag combined with the page policy
+int malloc_tag(uint64_t nbytes) {
+    int ret = numa_tag(nbytes);
+    if (nbytes >= page_threshold) {
+        ret |= static_cast<int>(page_policy) << PAGE_TAG_SHIFT;
+    }
+    return ret;
+}
+
+// Return the page policy of `tag`
+PagePolicy page_tag(int tag) {
+    return static_cast<PagePolicy>(tag >> PAGE_TAG_SHIFT);
+}
+
+// Return the name of the NUMA placement and page policy of `tag`
+std::string numa_tag_name(int tag) {
+    std::string ret;
+    switch (tag & NUMA_TAG_MASK) {
+        case 0:
+            ret = "default";
+            break;
+        case NUMA_TAG_INTERLEAVE:
+            ret = "interleave";
+            break;
+        case NUMA_TAG_FIRST_TOUCH:
+            ret = "first_touch";
+            break;
+        default:
+            ret = "node" + std::to_string((tag & NUMA_TAG_MASK) - NUMA_TAG_NODE);
+    }
+    switch (page_tag(tag)) {
+        case PagePolicy::THP:
+            return ret + " (thp)";
+        case PagePolicy::HUGETLB:
+            return ret + " (hugetlb)";
+        default:
+            return ret;
+    }
+}
+
+// Set the memory policy of the pages of `mem` where `nodes` is the set of nodes.
+// NB: the policy is only a hint thus errors (e.g. a kernel without NUMA support) are ignored
+void numa_bind(void *mem, uint64_t nbytes, int mode, const std::vector<int> &nodes) {
+#if defined(__linux__) && defined(SYS_mbind)
+    std::vector<unsigned long> mask(bh_numa_num_nodes() / (8 * sizeof(unsigned long)) + 1, 0);
+    for (int node: nodes) {
+        mask[node / (8 * sizeof(unsigned long))] |= 1ul << (node % (8 * sizeof(unsigned long)));
+    }
+    syscall(SYS_mbind, mem, nbytes, mode, mask.data(), mask.size() * 8 * sizeof(unsigned long) + 1, 0);
+#endif
+}
+
+// Return the size of the mapping of an allocation of `nbytes` with the malloc cache tag `tag`.
+// NB: `munmap()` of huge TLB pages requires a multiple of the huge page size
+uint64_t mapping_size(uint64_t nbytes, int tag) {
+    if (page_tag(tag) == PagePolicy::HUGETLB) {
+        return (nbytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+    return nbytes;
+}
+
+// Advise the kernel to back `mem` with transparent huge pages (ignored when not supported)
+void advise_huge_pages(void *mem, uint64_t nbytes) {
+#ifdef MADV_HUGEPAGE
+    madvise(mem, nbytes, MADV_HUGEPAGE);
+#endif
+}
+
+// Fault in the pages of `mem` using the calling thread
+void populate(void *mem, uint64_t nbytes) {
+#ifdef MADV_POPULATE_WRITE
+    if (madvise(mem, nbytes, MADV_POPULATE_WRITE) == 0) {
+        return;
+    }
+#endif
+    static const uint64_t page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    volatile char *m = static_cast<char *>(mem);
+    for (uint64_t i = 0; i < nbytes; i += page_size) {
+        m[i] = 0;
+    }
+}
+
+// Allocate page-size aligned main memory placed according to the NUMA placement and page policy of `tag`
+void *main_mem_malloc(uint64_t nbytes, int tag) {
+    const int numa = tag & NUMA_TAG_MASK;
+    const PagePolicy pages = page_tag(tag);
+    const bool prefault = prefault_policy != PrefaultPolicy::NONE and nbytes >= prefault_threshold and
+                          numa != NUMA_TAG_FIRST_TOUCH;
+    const uint64_t size = mapping_size(nbytes, tag);
+
     // The MAP_PRIVATE and MAP_ANONYMOUS flags is not 100% portable. See:
     // <http://stackoverflow.com/questions/4779188/how-to-use-mmap-to-allocate-a-memory-in-heap>
-    void *ret = mmap(0, nbytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_POPULATE
+    // Populating at `mmap()` is only possible when the pages need no advice or binding before they are touched
+    const bool map_populate = prefault and prefault_policy == PrefaultPolicy::POPULATE and numa == 0 and
+                              pages == PagePolicy::NONE;
+    if (map_populate) {
+        flags |= MAP_POPULATE;
+    }
+#else
+    const bool map_populate = false;
+#endif
+    void *ret = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (pages == PagePolicy::HUGETLB) {
+        int huge_flags = flags | MAP_HUGETLB;
+#ifdef MAP_HUGE_2MB
+        huge_flags |= MAP_HUGE_2MB;
+#endif
+        ret = mmap(0, size, PROT_READ | PROT_WRITE, huge_flags, -1, 0);
+    }
+#endif
+    const bool hugetlb = ret != MAP_FAILED;
+    if (not hugetlb) {
+        // NB: when the huge page pool is exhausted, we map the same size in order to free it like a huge mapping
+        ret = mmap(0, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    }
     if (ret == MAP_FAILED or ret == nullptr) {
         std::stringstream ss;
         ss << "main_mem_malloc() could not allocate a data region. Returned error code: " << strerror(errno);
         throw std::runtime_error(ss.str());
     }
+    if (pages == PagePolicy::THP or (pages == PagePolicy::HUGETLB and not hugetlb)) {
+        advise_huge_pages(ret, size);
+    }
+    if (numa == NUMA_TAG_INTERLEAVE) {
+        std::vector<int> nodes;
+        for (int i = 0; i < bh_numa_num_nodes(); ++i) {
+            nodes.push_back(i);
+        }
+        numa_bind(ret, size, MPOL_INTERLEAVE_MODE, nodes);
+    } else if (numa == NUMA_TAG_FIRST_TOUCH) {
+        if (numa_first_touch) {
+            numa_first_touch(ret, nbytes);
+        }
+    } else if (numa >= NUMA_TAG_NODE) {
+        numa_bind(ret, size, MPOL_PREFERRED_MODE, {numa - NUMA_TAG_NODE});
+    }
+    if (prefault and not map_populate) {
+        if (prefault_policy == PrefaultPolicy::PARALLEL and prefault_parallel_touch) {
+            prefault_parallel_touch(ret, nbytes);
+        } else {
+            populate(ret, nbytes);
+        }
+    }
     return ret;
 }
 
-void main_mem_free(void *mem, uint64_t nbytes) {
+void main_mem_free(void *mem, uint64_t nbytes, int tag) {
     assert(mem != nullptr);
-    if (munmap(mem, nbytes) != 0) {
+    if (munmap(mem, mapping_size(nbytes, tag)) != 0) {
         std::stringstream ss;
         ss << "main_mem_free() could not free a data region. " << "Returned error code: " << strerror(errno);
         throw std::runtime_error(ss.str());
     }
 }
 
-MallocCache malloc_cache(main_mem_malloc, main_mem_free, 0);
+MallocCache malloc_cache(MallocCache::FuncTaggedAllocT(main_mem_malloc), MallocCache::FuncTaggedFreeT(main_mem_free),
+                         0, MallocCache::DEFAULT_TOLERANCE, HUGE_PAGE_SIZE);
+
+// The spill state (see `bh_set_spill_budget()`). The limit of the malloc cache is capped by the budget.
+uint64_t spill_budget = 0;
+std::string spill_dir;
+uint64_t malloc_cache_limit = 0;
+
+// An array allocated through the malloc cache. Only arrays passed to `bh_spill_prepare()` are spillable.
+// NB: the data pointer of the base is compared with `mem` since it might have been reset outside of
+//     `bh_data_free()` (e.g. when the bridge takes over the memory)
+struct SpillResident {
+    void *mem;
+    uint64_t nbytes;
+    bool spillable;
+    uint64_t last_use;
+};
+std::map<const bh_base *, SpillResident> spill_resident;
+uint64_t spill_resident_bytes = 0;
+
+// An array spilled to an (unlinked) file, which is mapped at `mem`
+struct SpillFile {
+    void *mem;
+    uint64_t nbytes;
+    int fd;
+};
+std::map<const bh_base *, SpillFile> spill_files;
+
+// The arrays of the current kernel and the next use of arrays (see `bh_spill_prepare()`)
+std::set<const bh_base *> spill_protected;
+std::function<uint64_t(const bh_base *)> spill_next_use;
+uint64_t spill_clock = 0;
+
+uint64_t spill_stat_written = 0;
+uint64_t spill_stat_read = 0;
+
+// Write `base` to a spill file and replace its memory with a mapping of the file
+void spill_out(bh_base *base, const SpillResident &resident) {
+    std::string path = spill_dir + "/bh_spill_XXXXXX";
+    const int fd = mkstemp(&path[0]);
+    if (fd < 0) {
+        std::stringstream ss;
+        ss << "bh_data_malloc() could not create a spill file in '" << spill_dir << "'. Returned error code: "
+           << strerror(errno);
+        throw std::runtime_error(ss.str());
+    }
+    unlink(path.c_str());
+    const char *data = static_cast<const char *>(resident.mem);
+    uint64_t written = 0;
+    while (written < resident.nbytes) {
+        const ssize_t n = pwrite(fd, data + written, resident.nbytes - written, written);
+        if (n < 0 and errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            std::stringstream ss;
+            ss << "bh_data_malloc() could not write a spill file. Returned error code: " << strerror(errno);
+            close(fd);
+            throw std::runtime_error(ss.str());
+        }
+        written += static_cast<uint64_t>(n);
+    }
+    void *mem = mmap(0, resident.nbytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+        std::stringstream ss;
+        ss << "bh_data_malloc() could not map a spill file. Returned error code: " << strerror(errno);
+        close(fd);
+        throw std::runtime_error(ss.str());
+    }
+    // NB: the memory is released rather than cached since the purpose of spilling is to shrink the memory use
+    malloc_cache.release(resident.nbytes, resident.mem);
+    base->resetDataPtr(mem);
+    spill_files[base] = SpillFile{mem, resident.nbytes, fd};
+    spill_stat_written += resident.nbytes;
+}
+
+// Spill arrays until `nbytes` more bytes fit the budget (if possible)
+void spill_fit(uint64_t nbytes) {
+    // The memory retained by the malloc cache also counts towards the budget and is cheaper to let go than to spill
+    const uint64_t needed = spill_resident_bytes + nbytes;
+    malloc_cache.shrinkToFit(needed < spill_budget ? spill_budget - needed : 0);
+    while (spill_resident_bytes + nbytes > spill_budget) {
+        auto victim = spill_resident.end();
+        uint64_t victim_next_use = 0;
+        for (auto it = spill_resident.begin(); it != spill_resident.end();) {
+            if (it->first->getDataPtr() != it->second.mem) { // The memory has been taken over
+                spill_resident_bytes -= it->second.nbytes;
+                it = spill_resident.erase(it);
+                continue;
+            }
+            if (it->second.spillable and not util::exist(spill_protected, it->first)) {
+                // The array used last is spilled first and without `spill_next_use`, the least recently used
+                const uint64_t next_use = spill_next_use ? spill_next_use(it->first) :
+                                          std::numeric_limits<uint64_t>::max() - it->second.last_use;
+                if (victim == spill_resident.end() or next_use > victim_next_use or
+                    (next_use == victim_next_use and it->second.nbytes > victim->second.nbytes)) {
+                    victim = it;
+                    victim_next_use = next_use;
+                }
+            }
+            ++it;
+        }
+        if (victim == spill_resident.end()) {
+            return; // Nothing left to spill thus we exceed the budget
+        }
+        spill_resident_bytes -= victim->second.nbytes;
+        const SpillResident resident = victim->second;
+        bh_base *base = const_cast<bh_base *>(victim->first);
+        spill_resident.erase(victim);
+        spill_out(base, resident);
+    }
+}
+
+// Allocate `base` through the malloc cache and account it when spilling is enabled
+void *spill_alloc(bh_base *base, bool spillable) {
+    const uint64_t nbytes = base->nbytes();
+    if (spill_budget > 0) {
+        spill_fit(nbytes);
+    }
+    void *ret = malloc_cache.alloc(nbytes, malloc_tag(nbytes));
+    if (spill_budget > 0 and ret != nullptr) {
+        SpillResident &resident = spill_resident[base];
+        spill_resident_bytes -= resident.nbytes; // Non-zero when `base` reuses the address of a lost base
+        resident = SpillResident{ret, nbytes, spillable, ++spill_clock};
+        spill_resident_bytes += nbytes;
+    }
+    return ret;
+}
+
+// Fault `base` back in from its spill file
+void spill_in(bh_base *base) {
+    auto it = spill_files.find(base);
+    assert(it != spill_files.end());
+    const SpillFile file = it->second;
+    spill_files.erase(it);
+    void *mem = spill_alloc(base, true);
+    memcpy(mem, file.mem, file.nbytes);
+    munmap(file.mem, file.nbytes);
+    close(file.fd);
+    base->resetDataPtr(mem);
+    spill_stat_read += file.nbytes;
+}
+
+// Release the spill file of `it`
+void spill_release(std::map<const bh_base *, SpillFile>::iterator it) {
+    munmap(it->second.mem, it->second.nbytes);
+    close(it->second.fd);
+    spill_files.erase(it);
+}
+
+// The data TLB load misses counter (-1 when not available)
+int dtlb_counter() {
+    static int fd = -2;
+    if (fd == -2) {
+        fd = -1;
+#if defined(__linux__) && defined(SYS_perf_event_open)
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.inherit = 1; // Count the threads created after this call such as the OpenMP threads
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    return fd;
+}
+}
+
+void bh_set_numa_policy(NumaPolicy policy, uint64_t threshold, std::function<void(void *, uint64_t)> first_touch) {
+    numa_policy = policy;
+    numa_threshold = threshold;
+    numa_first_touch = first_touch;
+}
+
+void bh_set_page_policy(PagePolicy page_policy, uint64_t page_threshold, PrefaultPolicy prefault,
+                        uint64_t prefault_threshold, std::function<void(void *, uint64_t)> parallel_touch) {
+    ::page_policy = page_policy;
+    ::page_threshold = page_threshold;
+    prefault_policy = prefault;
+    ::prefault_threshold = prefault_threshold;
+    prefault_parallel_touch = parallel_touch;
+}
+
+void bh_get_page_fault_stat(uint64_t &minor_faults, uint64_t &major_faults, int64_t &dtlb_misses) {
+    // The counters are relative to the first call
+    static struct rusage first_usage;
+    static bool first = true;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    if (first) {
+        first_usage = usage;
+        first = false;
+    }
+    minor_faults = static_cast<uint64_t>(usage.ru_minflt - first_usage.ru_minflt);
+    major_faults = static_cast<uint64_t>(usage.ru_majflt - first_usage.ru_majflt);
+
+    dtlb_misses = -1;
+    const int fd = dtlb_counter();
+    uint64_t count;
+    if (fd >= 0 and read(fd, &count, sizeof(count)) == sizeof(count)) {
+        dtlb_misses = static_cast<int64_t>(count);
+    }
+}
+
+void bh_set_spill_budget(uint64_t budget, const std::string &dir) {
+    spill_budget = budget;
+    spill_dir = dir;
+    bh_set_malloc_cache_limit(malloc_cache_limit);
+}
+
+bool bh_spill_enabled() {
+    return spill_budget > 0;
+}
+
+void bh_spill_prepare(const std::vector<bh_base *> &bases, std::function<uint64_t(const bh_base *)> next_use) {
+    spill_protected.clear();
+    spill_protected.insert(bases.begin(), bases.end());
+    spill_next_use = next_use;
+    if (spill_budget == 0) {
+        return;
+    }
+    for (bh_base *base: bases) {
+        auto it = spill_resident.find(base);
+        if (it != spill_resident.end()) {
+            it->second.spillable = true;
+            it->second.last_use = ++spill_clock;
+        } else if (util::exist(spill_files, base) and base->getDataPtr() == spill_files.at(base).mem) {
+            spill_in(base);
+        }
+    }
+}
+
+void bh_get_spill_stat(uint64_t &spilled_bytes, uint64_t &restored_bytes) {
+    spilled_bytes = spill_stat_written;
+    restored_bytes = spill_stat_read;
 }
 
 void bh_data_malloc(bh_base *base) {
     if (base == nullptr) return;
     if (base->getDataPtr() != nullptr) return;
-    base->resetDataPtr(malloc_cache.alloc(base->nbytes()));
+    // NB: an array allocated for the current kernel is spillable like the other arrays of the kernel
+    base->resetDataPtr(spill_alloc(base, spill_budget > 0 and util::exist(spill_protected, base)));
 }
 
 void bh_data_free(bh_base *base) {
     if (base == nullptr) return;
     if (base->getDataPtr() == nullptr) return;
+    if (not spill_files.empty()) {
+        auto it = spill_files.find(base);
+        if (it != spill_files.end()) {
+            const bool spilled = it->second.mem == base->getDataPtr();
+            spill_release(it);
+            if (spilled) {
+                base->resetDataPtr();
+                return;
+            }
+        }
+    }
+    if (not spill_resident.empty()) {
+        auto it = spill_resident.find(base);
+        if (it != spill_resident.end()) {
+            spill_resident_bytes -= it->second.nbytes;
+            spill_resident.erase(it);
+        }
+    }
     malloc_cache.free(base->nbytes(), base->getDataPtr());
     base->resetDataPtr();
 }
 
 void bh_set_malloc_cache_limit(uint64_t nbytes) {
-    malloc_cache.setLimit(nbytes);
+    malloc_cache_limit = nbytes;
+    malloc_cache.setLimit(spill_budget > 0 ? std::min(nbytes, spill_budget) : nbytes);
+}
+
+void bh_set_malloc_cache_tolerance(double tolerance) {
+    malloc_cache.setTolerance(tolerance);
 }
 
 void bh_get_malloc_cache_stat(uint64_t &cache_lookup, uint64_t &cache_misses, uint64_t &max_memory_usage) {
@@ -130,3 +642,8 @@ void bh_get_malloc_cache_stat(uint64_t &cache_lookup, uint64_t &cache_misses, ui
     max_memory_usage = malloc_cache.getMaxMemAllocated();
 }
 
+void bh_get_malloc_cache_numa_stat(std::map<std::string, uint64_t> &max_memory_usage) {
+    for (const auto &tag: malloc_cache.getMaxMemAllocatedPerTag()) {
+        max_memory_usage[numa_tag_name(tag.first)] = tag.second;
+    }
+}
@@ -31,14 +31,14 @@ namespace fs = boost::filesystem;
 
 namespace util {
 
-void remove_old_files(const fs::path &dir, int64_t num_of_newest_to_keep) {
+void remove_old_files(const fs::path &dir, int64_t num_of_newest_to_keep, const std::string &extension) {
     assert(not dir.empty());
     fs::directory_iterator dir_first(dir), dir_last;
     std::vector<fs::path> files;
 
-    auto pred = [](const fs::directory_entry& p)
+    auto pred = [&extension](const fs::directory_entry& p)
     {
-        return fs::is_regular_file(p);
+        return fs::is_regular_file(p) and (extension.empty() or p.path().extension() == extension);
     };
 
     std::copy(boost::make_filter_iterator(pred, dir_first, dir_last),
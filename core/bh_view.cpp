@@ -31,20 +31,6 @@ If not, see <http://www.gnu.org/licenses/>.
 
 using namespace std;
 
-bh_view::bh_view(const bh_view &view) {
-    base = view.base;
-    if (base == nullptr) {
-        return; //'view' is a constant thus the rest are garbage
-    }
-
-    start = view.start;
-    ndim = view.ndim;
-    assert(ndim < BH_MAXDIM);
-    slides = view.slides;
-    shape = view.shape;
-    stride = view.stride;
-}
-
 void bh_view::insert_axis(int64_t dim, int64_t size, int64_t stride) {
     assert(dim <= ndim);
     this->shape.insert(this->shape.begin() + dim, size);
@@ -66,7 +52,6 @@ void bh_view::transpose(int64_t axis1, int64_t axis2) {
     assert(not isConstant());
     std::swap(shape[axis1], shape[axis2]);
     std::swap(stride[axis1], stride[axis2]);
-    slides.transpose(axis1, axis2);
 }
 
 bool bh_view::isContiguous() const {
@@ -24,6 +24,8 @@ def gen_headerfile( opcodes ):
         raise ValueError("opcodes.json contains opcode duplicates: %s" % str(l))
 
     max_ops = max([int(o['id']) for o in opcodes])
+    # NB: extension methods take three operands
+    max_nop = max([3] + [int(o['nop']) for o in opcodes])
     return """
 /*
  * Do not edit this file. It has been auto generated by
@@ -42,7 +44,8 @@ enum { /* bh_opcode */
 __OPCODES__
 
     BH_NO_OPCODES = __NO_OPCODES__, // The amount of opcodes
-    BH_MAX_OPCODE_ID = __MAX_OP__   // The extension method offset
+    BH_MAX_OPCODE_ID = __MAX_OP__,  // The extension method offset
+    BH_MAX_NO_OPERANDS = __MAX_NOP__  // The maximum number of operands of an instruction
 };
 
 /* Text string for operation
@@ -92,7 +95,7 @@ bool bh_opcode_is_sweep(bh_opcode opcode);
 }
 #endif
 
-""".replace('__TIMESTAMP__', stamp).replace('__OPCODES__', '\n'.join(enums)).replace('__NO_OPCODES__', str(len(opcodes))).replace('__MAX_OP__',str(max_ops))
+""".replace('__TIMESTAMP__', stamp).replace('__OPCODES__', '\n'.join(enums)).replace('__NO_OPCODES__', str(len(opcodes))).replace('__MAX_OP__',str(max_ops)).replace('__MAX_NOP__', str(max_nop))
 
 def gen_cfile(opcodes):
     text      = ['        case %s: return "%s";' % (opcode['opcode'], opcode['opcode']) for opcode in opcodes]
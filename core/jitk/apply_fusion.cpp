@@ -54,6 +54,10 @@ void apply_transformers(const FusionConfig &config, vector<Block> &block_list) {
             split_for_threading(block_list);
         } else if (*it == "collapse_redundant_axes") {
             collapse_redundant_axes(block_list);
+        } else if (*it == "interchange_loops") {
+            interchange_loops(block_list);
+        } else if (*it == "tile_for_cache") {
+            tile_for_cache(block_list, config.tile_cache_size, config.tile_l2_cache_size);
         } else if (*it == "serial") {
             fuser_serial(block_list, config.avoid_rank0_sweep);
         } else if (*it == "breadth_first") {
@@ -62,6 +66,8 @@ void apply_transformers(const FusionConfig &config, vector<Block> &block_list) {
             fuser_reshapable_first(block_list, config.avoid_rank0_sweep);
         } else if (*it == "greedy") {
             fuser_greedy(config, block_list);
+        } else if (*it == "cost_model") {
+            fuser_cost_model(config, block_list);
         } else {
             cout << "Unknown transformer: \"" << *it << "\"" << endl;
             throw runtime_error("Unknown transformer!");
@@ -178,7 +184,8 @@ vector<Block> get_block_list(const vector<bh_instruction *> &instr_list, const F
                              Statistics &stat) {
     vector<Block> block_list;
     bool hit;
-    tie(block_list, hit) = fcache.get(instr_list);
+    const uint64_t lookup_hash = FuseCache::hash(instr_list);
+    tie(block_list, hit) = fcache.get(instr_list, lookup_hash);
     if (not hit) {
         const auto tpre_fusion = chrono::steady_clock::now();
         stat.num_instrs_into_fuser += instr_list.size();
@@ -191,7 +198,7 @@ vector<Block> get_block_list(const vector<bh_instruction *> &instr_list, const F
         // Then we fuse fully
         apply_transformers(config, block_list);
         stat.time_fusion += chrono::steady_clock::now() - tfusion;
-        fcache.insert(instr_list, block_list);
+        fcache.insert(instr_list, lookup_hash, block_list);
     }
 
     // Pretty printing the block
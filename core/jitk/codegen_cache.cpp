@@ -20,8 +20,11 @@ If not, see <http://www.gnu.org/licenses/>.
 
 #include <vector>
 #include <iostream>
+#include <algorithm>
 
 #include <bohrium/jitk/codegen_cache.hpp>
+#include <bohrium/jitk/codegen_util.hpp>
+#include <bohrium/jitk/view.hpp>
 
 using namespace std;
 
@@ -30,102 +33,185 @@ namespace jitk {
 
 namespace {
 
+constexpr uint64_t SEP_INSTR = UINT64_MAX;
+constexpr uint64_t SEP_LOOP = UINT64_MAX - 1;
+constexpr uint64_t SEP_END = UINT64_MAX - 2;
+constexpr uint64_t SEP_CONSTANT = UINT64_MAX - 3;
+
 /* The View hash consists of the following fields:
- * <view_id><start><ndim>[<shape><stride><SEP_SHAPE>...]<SEP_OP>
+ * <dtype><base_id>(<offset_strides_id>|<start><ndim>[<shape><stride>...])[<index_id><is_scalar()>]
  */
-void hash_stream(const bh_view &view, const SymbolTable &symbols, std::stringstream &ss) {
-    ss << "dtype: " << static_cast<uint32_t>(view.base->dtype());
-    ss << "baseid: " << symbols.baseID(view.base);
+void hash_view(const bh_view &view, const SymbolTable &symbols, util::Hasher &hasher) {
+    hasher.add(view.base->dtype()).add(symbols.baseID(view.base));
 
     if (symbols.strides_as_var) {
-        ss << "strideid: " << symbols.offsetStridesID(view);
+        hasher.add(symbols.offsetStridesID(view));
     } else {
-        ss << "vstart: " << view.start;
-        for (int j = 0; j < view.ndim; ++j) {
-            ss << "dim: " << j;
-            ss << "shape: " << view.shape[j];
-            ss << "stride: " << view.stride[j];
+        hasher.add(view.start).add(view.ndim);
+        for (int64_t j = 0; j < view.ndim; ++j) {
+            hasher.add(view.shape[j]).add(view.stride[j]);
         }
     }
     if (symbols.index_as_var) {
-        ss << "indexid: " << symbols.idxID(view);
-        if (view.is_scalar()) { // We optimize indexes into 1-sized arrays, which we need the hash to reflect
-            ss << "is-1-elem: " << endl;
-        }
+        hasher.add(symbols.idxID(view));
+    }
+    if (symbols.index_as_var or symbols.shape_as_var) {
+        // We optimize indexes into 1-sized arrays, which we need the hash to reflect
+        hasher.add(view.is_scalar());
+    }
+}
+
+// Hash the value of `constant`, which is written into the source code
+void hash_constant(const bh_constant &constant, util::Hasher &hasher) {
+    hasher.add(constant.type);
+    const bh_constant_value &value = constant.value;
+    switch (constant.type) {
+        case bh_type::BOOL:       hasher.add(value.bool8);  break;
+        case bh_type::INT8:       hasher.add(value.int8);   break;
+        case bh_type::INT16:      hasher.add(value.int16);  break;
+        case bh_type::INT32:      hasher.add(value.int32);  break;
+        case bh_type::INT64:      hasher.add(value.int64);  break;
+        case bh_type::UINT8:      hasher.add(value.uint8);  break;
+        case bh_type::UINT16:     hasher.add(value.uint16); break;
+        case bh_type::UINT32:     hasher.add(value.uint32); break;
+        case bh_type::UINT64:     hasher.add(value.uint64); break;
+        case bh_type::FLOAT32:    hasher.add(value.float32); break;
+        case bh_type::FLOAT64:    hasher.add(value.float64); break;
+        case bh_type::COMPLEX64:  hasher.add(value.complex64.real).add(value.complex64.imag); break;
+        case bh_type::COMPLEX128: hasher.add(value.complex128.real).add(value.complex128.imag); break;
+        case bh_type::R123:       hasher.add(value.r123.start).add(value.r123.key); break;
+        default:
+            throw runtime_error("hash_constant(): unknown constant type");
     }
 }
 
 /* The Instruction hash consists of the following fields:
- * <opcode[<hash_view>...]<sweep_axis()><SEP_INSTR>
+ * <SEP_INSTR><opcode><number of operands>[<hash_view>|<SEP_CONSTANT><const_id>|<hash_constant>...]<sweep_axis()>
+ * NB: BH_RANGE also hashes the offset-and-strides ID of the view of its range (see `range_index_view()`)
  */
-void hash_stream(const bh_instruction &instr, const SymbolTable &symbols, std::stringstream &ss) {
-    ss << "opcode: " << instr.opcode;
+void hash_instr(const bh_instruction &instr, const SymbolTable &symbols, util::Hasher &hasher) {
+    hasher.add(SEP_INSTR).add(instr.opcode).add(instr.operand.size());
     for (const bh_view &op: instr.operand) {
         if (op.isConstant()) {
-            int64_t id = symbols.constID(instr);
+            hasher.add(SEP_CONSTANT);
+            const int64_t id = symbols.constID(instr);
             if (id >= 0 and symbols.const_as_var) {
-                ss << "const: " << symbols.constID(instr);
+                hasher.add(id).add(instr.constant.type);
             } else {
-                ss << "const: " << instr.constant;
+                hasher.add(-1);
+                hash_constant(instr.constant, hasher);
             }
-            ss << "const dtype: " << static_cast<uint32_t >(instr.constant.type);
         } else {
-            hash_stream(op, symbols,  ss);
+            hash_view(op, symbols, hasher);
         }
     }
-    ss << "sweep: " << instr.sweep_axis();
+    if (instr.opcode == BH_RANGE and symbols.strides_as_var) {
+        hasher.add(symbols.offsetStridesID(range_index_view(instr.operand[0])));
+    }
+    hasher.add(instr.sweep_axis());
 }
 
 /* The Block hash consists of the following fields:
- * <block_rank><instr_hash><SEP_BLOCK>
+ * <SEP_LOOP><rank><size><number of frees>[<freed base id>...][<hash_instr>|<hash_loop>...]<SEP_END>
+ * NB: when the sizes of the loops are variables, we only hash whether the size is zero, one, or more
+ *     since that is all the code generators use. But the shapes of the outputs of sweeps at rank 0 are still
+ *     hashed since OpenMP array section reductions use them. Likewise, when the strides are variables, we hash
+ *     whether the span of each of these outputs is within `ARRAY_SECTION_MAX_SPAN`, which decides between an
+ *     array section reduction and atomic guards.
  */
-void hash_stream(const LoopB &block, const SymbolTable &symbols, std::stringstream &ss) {
-    ss << "rank: " << block.rank;
-    ss << "size: " << block.size;
+void hash_loop(const LoopB &block, const SymbolTable &symbols, util::Hasher &hasher) {
+    hasher.add(SEP_LOOP).add(block.rank);
+    if (symbols.shape_as_var) {
+        hasher.add(std::min(block.size, int64_t{2}));
+    } else {
+        hasher.add(block.size);
+    }
+    if (block.rank == 0 and (symbols.shape_as_var or symbols.strides_as_var)) {
+        // NB: `_sweeps` is ordered by address thus we sort the hashes of the outputs
+        vector<uint64_t> sweep_outputs;
+        for (const InstrPtr &instr: block._sweeps) {
+            const bh_view &view = instr->operand[0];
+            util::Hasher output_hasher;
+            if (symbols.shape_as_var) {
+                output_hasher.add(view.ndim);
+                for (int64_t j = 0; j < view.ndim; ++j) {
+                    output_hasher.add(view.shape[j]);
+                }
+            }
+            if (symbols.strides_as_var) {
+                output_hasher.add(array_section_span(view) <= ARRAY_SECTION_MAX_SPAN);
+            }
+            sweep_outputs.push_back(output_hasher.digest());
+        }
+        std::sort(sweep_outputs.begin(), sweep_outputs.end());
+        hasher.add(sweep_outputs.size());
+        for (uint64_t output: sweep_outputs) {
+            hasher.add(output);
+        }
+    }
+    hasher.add(block._frees.size());
     {  // The order of BH_FREE within a block doesn't matter, thus we sort the freed base IDs here
-        ss << "freed: ";
-        set<uint64_t>sorted_freed_bases;
+        vector<uint64_t> sorted_freed_bases;
+        sorted_freed_bases.reserve(block._frees.size());
         for (const bh_base *b: block._frees) {
-            sorted_freed_bases.insert(symbols.baseID(b));
+            sorted_freed_bases.push_back(symbols.baseID(b));
         }
-        for(uint64_t b_id: sorted_freed_bases) {
-            ss << b_id << ",";
+        std::sort(sorted_freed_bases.begin(), sorted_freed_bases.end());
+        for (uint64_t b_id: sorted_freed_bases) {
+            hasher.add(b_id);
         }
     }
     for (const Block &b: block._block_list) {
         if (b.isInstr()) {
             if (b.getInstr()->opcode != BH_FREE) {
-                hash_stream(*b.getInstr(), symbols, ss);
+                hash_instr(*b.getInstr(), symbols, hasher);
             }
         } else {
-            hash_stream(b.getLoop(), symbols, ss);
+            hash_loop(b.getLoop(), symbols, hasher);
         }
     }
+    hasher.add(SEP_END);
 }
 
-/* The Block hash from above as an uint64_t */
-uint64_t hash_stream(const LoopB &block, const SymbolTable &symbols) {
-    stringstream ss;
-    hash_stream(block, symbols, ss);
-    return util::hash(ss.str());
-}
+// The header of the files in the persistent cache. Increase the version when changing the format.
+const string PERSISTENT_HEADER = "// Bohrium codegen cache v2\n";
 } // Anonymous Namespace
 
+boost::filesystem::path CodegenCache::persistentPath(uint64_t lookup_hash) const {
+    return _persistent_dir / hash_filename(_config_hash, lookup_hash, ".src");
+}
+
+uint64_t CodegenCache::hash(const LoopB &kernel, const SymbolTable &symbols) {
+    util::Hasher hasher;
+    hash_loop(kernel, symbols, hasher);
+    return hasher.digest();
+}
+
 std::pair<std::string, uint64_t> CodegenCache::lookup(const LoopB &kernel, const SymbolTable &symbols) {
     ++stat.codegen_cache_lookups;
-    const uint64_t lookup_hash = hash_stream(kernel, symbols);
+    const uint64_t lookup_hash = hash(kernel, symbols);
     auto lookup = _cache.find(lookup_hash);
     if (lookup != _cache.end()) { // Cache hit!
         return make_pair(lookup->second, lookup_hash);
+    }
+    string data;
+    if (not _persistent_dir.empty() and read_file_mapped(persistentPath(lookup_hash), data) and
+        data.compare(0, PERSISTENT_HEADER.size(), PERSISTENT_HEADER) == 0) { // Persistent cache hit!
+        ++stat.codegen_cache_disk_hits;
+        string &source = _cache[lookup_hash];
+        source = data.substr(PERSISTENT_HEADER.size());
+        return make_pair(source, lookup_hash);
     } else {
         ++stat.codegen_cache_misses;
         return make_pair("", lookup_hash);
     }
 }
 
-void CodegenCache::insert(std::string source, const LoopB &kernel, const SymbolTable &symbols) {
-    const uint64_t lookup_hash = hash_stream(kernel, symbols);
+void CodegenCache::insert(std::string source, uint64_t lookup_hash) {
     assert(_cache.find(lookup_hash) == _cache.end()); // The source shouldn't exist in the cache already
+    if (not (_persistent_dir.empty() or _readonly)) {
+        write_file_atomically(persistentPath(lookup_hash), PERSISTENT_HEADER + source);
+    }
     _cache[lookup_hash] = std::move(source);
 }
 
@@ -24,7 +24,10 @@ If not, see <http://www.gnu.org/licenses/>.
 #include <chrono>         // std::chrono::seconds
 #include <unistd.h>
 #include <sstream>
+#include <fstream>
 #include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <bohrium/jitk/codegen_util.hpp>
 #include <bohrium/jitk/view.hpp>
 #include <bohrium/jitk/instruction.hpp>
@@ -56,6 +59,43 @@ boost::filesystem::path write_source2file(const std::string &src,
     return srcfile;
 }
 
+bool write_file_atomically(const boost::filesystem::path &path, const std::string &data) {
+    namespace fs = boost::filesystem;
+    try {
+        const fs::path tmp = path.parent_path() / fs::unique_path(path.filename().string() + ".%%%%-%%%%-%%%%.tmp");
+        {
+            ofstream ofs(tmp.string(), ios::binary);
+            ofs.write(data.data(), data.size());
+            if (not ofs) {
+                ofs.close();
+                fs::remove(tmp);
+                return false;
+            }
+        }
+        fs::rename(tmp, path); // NB: rename is atomic when `tmp` and `path` are on the same filesystem
+        return true;
+    } catch (const std::runtime_error &e) { // Includes `boost::filesystem::filesystem_error`
+        return false;
+    }
+}
+
+bool read_file_mapped(const boost::filesystem::path &path, std::string &out) {
+    namespace ip = boost::interprocess;
+    try {
+        if (not boost::filesystem::exists(path) or boost::filesystem::file_size(path) == 0) {
+            return false;
+        }
+        const ip::file_mapping mapping(path.string().c_str(), ip::read_only);
+        const ip::mapped_region region(mapping, ip::read_only);
+        out.assign(static_cast<const char *>(region.get_address()), region.get_size());
+        return true;
+    } catch (const ip::interprocess_exception &e) {
+        return false;
+    } catch (const boost::filesystem::filesystem_error &e) {
+        return false;
+    }
+}
+
 boost::filesystem::path get_tmp_path(const ConfigParser &config) {
     boost::filesystem::path tmp_path, unique_path;
     const boost::filesystem::path tmp_dir = config.defaultGet<boost::filesystem::path>("tmp_dir", "NONE");
@@ -109,6 +149,14 @@ std::vector<InstrPtr> order_sweep_set(const std::set<InstrPtr> &sweep_set, const
     return ret;
 }
 
+uint64_t array_section_span(const bh_view &view) {
+    uint64_t ret = 1;
+    for (int i = 0; i < view.ndim; ++i) {
+        ret += std::abs((view.shape[i] - 1) * view.stride[i]);
+    }
+    return ret;
+}
+
 bool row_major_access(const bh_view &view) {
     if(not view.isConstant()) {
         assert(view.ndim > 0);
@@ -132,7 +180,12 @@ bool row_major_access(const bh_instruction &instr) {
 
 void to_column_major(std::vector<bh_instruction> &instr_list) {
     for(bh_instruction &instr: instr_list) {
-        if (instr.opcode < BH_MAX_OPCODE_ID and row_major_access(instr)) {
+        // NB: the slide of a view refers to the axes of the untransposed view
+        bool has_slide = false;
+        for (const bh_view &view: instr.getViews()) {
+            has_slide = has_slide or view.hasSlide();
+        }
+        if (instr.opcode < BH_MAX_OPCODE_ID and not has_slide and row_major_access(instr)) {
             instr.transpose();
         }
     }
@@ -20,6 +20,7 @@ If not, see <http://www.gnu.org/licenses/>.
 
 #include <sstream>
 #include <stdexcept>
+#include <mutex>
 #include <boost/algorithm/string/replace.hpp>
 #include <bohrium/jitk/compiler.hpp>
 #include <bohrium/jitk/subprocess.hpp>
@@ -30,6 +31,12 @@ namespace P = subprocess;
 namespace bohrium {
 namespace jitk {
 
+namespace {
+// Serializes the spawning of compile processes, which makes `Compiler::compile()` thread-safe.
+// NB: the pipes are created before they get their FD_CLOEXEC flag, thus a concurrent fork() could leak
+//     them into another compiler process, which then keeps the pipes open.
+std::mutex spawn_mutex;
+}
 
 /** Returns the command where {OUT} and {IN} are expanded. */
 string expand_compile_cmd(const string &cmd_template, const string &out, const string &in, const string &config_path) {
@@ -46,7 +53,9 @@ void Compiler::compile(const boost::filesystem::path &output_file, const string
     if (verbose) {
         cout << "compile command: \"" << cmd << "\"" << endl;
     }
+    std::unique_lock<std::mutex> spawn_lock(spawn_mutex);
     P::Popen p = P::Popen(cmd, P::input{P::PIPE}, P::output{P::PIPE}, P::error{P::PIPE});
+    spawn_lock.unlock();
     p.send(source.c_str(), source.size());
     auto res = p.communicate();
     stringstream ss;
@@ -63,7 +72,9 @@ void Compiler::compile(const boost::filesystem::path &output_file, const boost::
     if (verbose) {
         cout << "compile command: \"" << cmd << "\"" << endl;
     }
+    std::unique_lock<std::mutex> spawn_lock(spawn_mutex);
     P::Popen p = P::Popen(cmd, P::output{P::PIPE}, P::error{P::PIPE});
+    spawn_lock.unlock();
     auto res = p.communicate();
     stringstream ss;
     ss << "[JIT compiler fatal error retcode: " << p.retcode() << "]\n";
@@ -0,0 +1,126 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <dlfcn.h>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <bohrium/jitk/compiler_tcc.hpp>
+
+using namespace std;
+
+namespace bohrium {
+namespace jitk {
+
+namespace {
+// Constants from `libtcc.h`
+constexpr int TCC_OUTPUT_MEMORY = 1;
+void *const TCC_RELOCATE_AUTO = reinterpret_cast<void *>(1);
+
+// Load the symbol `name` from `lib` into `func`
+template<typename T>
+void load_symbol(void *lib, const char *name, T &func) {
+    dlerror(); // Reset errors
+    *(void **) (&func) = dlsym(lib, name);
+    const char *dlsym_error = dlerror();
+    if (dlsym_error != nullptr) {
+        throw runtime_error(string("CompilerTCC: cannot load libtcc function: ") + dlsym_error);
+    }
+}
+
+// The error callback of libtcc, which appends the error message to the string `opaque`
+void error_func(void *opaque, const char *msg) {
+    *static_cast<string *>(opaque) += string(msg) + "\n";
+}
+}
+
+CompilerTCC::CompilerTCC(const string &cmd_template, const string &lib_path, bool verbose) : verbose(verbose) {
+    _lib = dlopen(lib_path.c_str(), RTLD_NOW);
+    if (_lib == nullptr) {
+        throw runtime_error(string("CompilerTCC: cannot load libtcc: ") + dlerror());
+    }
+    load_symbol(_lib, "tcc_new", _tcc_new);
+    load_symbol(_lib, "tcc_delete", _tcc_delete);
+    load_symbol(_lib, "tcc_set_error_func", _tcc_set_error_func);
+    load_symbol(_lib, "tcc_set_output_type", _tcc_set_output_type);
+    load_symbol(_lib, "tcc_add_include_path", _tcc_add_include_path);
+    load_symbol(_lib, "tcc_define_symbol", _tcc_define_symbol);
+    load_symbol(_lib, "tcc_compile_string", _tcc_compile_string);
+    load_symbol(_lib, "tcc_relocate", _tcc_relocate);
+    load_symbol(_lib, "tcc_get_symbol", _tcc_get_symbol);
+
+    // Let's find the include paths and macros of the compile command
+    vector<string> tokens;
+    boost::split(tokens, cmd_template, boost::is_any_of(" \t"), boost::token_compress_on);
+    for (const string &token: tokens) {
+        if (token.compare(0, 2, "-I") == 0 and token.size() > 2) {
+            _include_paths.push_back(token.substr(2));
+        } else if (token.compare(0, 2, "-D") == 0 and token.size() > 2) {
+            const size_t eq = token.find('=');
+            if (eq == string::npos) {
+                _defines.emplace_back(token.substr(2), "1");
+            } else {
+                _defines.emplace_back(token.substr(2, eq - 2), token.substr(eq + 1));
+            }
+        }
+    }
+}
+
+CompilerTCC::~CompilerTCC() {
+    for (void *state: _states) {
+        _tcc_delete(state);
+    }
+    // NB: we never close `_lib` since the kernels might still be in use
+}
+
+void *CompilerTCC::compile(const string &source, const string &func_name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    string errors;
+    void *state = _tcc_new();
+    if (state == nullptr) {
+        throw runtime_error("CompilerTCC: cannot create a libtcc state");
+    }
+    _tcc_set_error_func(state, &errors, error_func);
+    _tcc_set_output_type(state, TCC_OUTPUT_MEMORY);
+    for (const string &path: _include_paths) {
+        _tcc_add_include_path(state, path.c_str());
+    }
+    for (const auto &define: _defines) {
+        _tcc_define_symbol(state, define.first.c_str(), define.second.c_str());
+    }
+
+    void *func = nullptr;
+    if (_tcc_compile_string(state, source.c_str()) == 0 and _tcc_relocate(state, TCC_RELOCATE_AUTO) >= 0) {
+        func = _tcc_get_symbol(state, func_name.c_str());
+    }
+    if (func == nullptr) {
+        if (verbose) {
+            cout << "[CompilerTCC] failed to compile \"" << func_name << "\":\n" << errors << endl;
+        }
+        _tcc_delete(state);
+        return nullptr;
+    }
+    _states.push_back(state);
+    return func;
+}
+
+}
+}
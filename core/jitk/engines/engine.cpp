@@ -64,6 +64,10 @@ void Engine::writeKernelFunctionArguments(const jitk::SymbolTable &symbols,
         }
     }
 
+    for (size_t i = 0; i < symbols.loopSizes().size(); ++i) {
+        stmp << writeType(bh_type::UINT64) << " ls" << i << ", ";
+    }
+
     if (not symbols.constIDs().empty()) {
         for (auto it = symbols.constIDs().begin(); it != symbols.constIDs().end(); ++it) {
             const InstrPtr &instr = *it;
@@ -112,6 +116,26 @@ void Engine::writeBlock(const SymbolTable &symbols,
         }
     }
 
+    // Let's declare the partial indexes of the arrays accessed by the loops below this loop, which then only
+    // add the terms of their own axes to the partial index of this loop
+    if (kernel.rank >= 0 and symbols.index_strength_reduce) {
+        for (const InstrPtr &instr: iterator::allInstr(kernel)) {
+            for (const bh_view &view: instr->getViews()) {
+                if (view.ndim <= kernel.rank + 1 or view.is_scalar() or scope.isTmp(view.base) or
+                    scope.isPartialIdxDeclared(view, kernel.rank)) {
+                    continue;
+                }
+                // A zero stride makes the partial index of this loop the same as the one of the parent loop
+                if (not symbols.strides_as_var and view.stride[kernel.rank] == 0) {
+                    continue;
+                }
+                util::spaces(out, 8 + kernel.rank * 4);
+                scope.writePartialIdxDeclaration(view, kernel.rank, writeType(bh_type::UINT64), out);
+                out << "\n";
+            }
+        }
+    }
+
     // Let's declare indexes if we are not at the kernel level (rank == -1)
     if (kernel.rank >= 0) {
         for (const InstrPtr &instr: iterator::allLocalInstr(kernel)) {
@@ -222,6 +246,7 @@ void Engine::writeBlock(const SymbolTable &symbols,
             writeBlock(symbols, &scope, b.getLoop(), thread_stack, opencl, out);
             util::spaces(out, 4 + b.rank() * 4);
             out << "}\n";
+            loopTailWriter(symbols, scope, b.getLoop(), thread_stack, out);
         }
     }
 
@@ -257,7 +282,7 @@ void Engine::writeInstr(Scope &scope, const bh_instruction &instr, int indent, b
         // Let's find the flatten index of the output view
         stringstream ss;
         ss << "(";
-        write_array_index(scope, instr.operand[0], ss);
+        write_array_index(scope, range_index_view(instr.operand[0]), ss);
         ss << ")";
         ops.push_back(ss.str());
     } else if (instr.opcode == BH_RANDOM) {
@@ -19,12 +19,16 @@ If not, see <http://www.gnu.org/licenses/>.
 */
 #include <vector>
 #include <set>
+#include <map>
+#include <limits>
+#include <algorithm>
 
 #include <bohrium/jitk/engines/engine_cpu.hpp>
 
 #include <bohrium/bh_config_parser.hpp>
 #include <bohrium/jitk/statistics.hpp>
 #include <bohrium/jitk/apply_fusion.hpp>
+#include <bohrium/jitk/graph.hpp>
 
 #include <bohrium/bh_view.hpp>
 #include <bohrium/bh_component.hpp>
@@ -36,6 +40,76 @@ using namespace std;
 namespace bohrium {
 namespace jitk {
 
+bool EngineCPU::specializeShape(uint64_t codegen_hash, const SymbolTable &symbols) {
+    if (shape_specialize_threshold == 0) {
+        return false;
+    }
+    util::Hasher hasher(codegen_hash);
+    for (int64_t size: symbols.loopSizes()) {
+        hasher.add(size);
+    }
+    return ++shape_executions[hasher.digest()] >= shape_specialize_threshold;
+}
+
+pair<string, uint64_t> EngineCPU::getSource(const LoopB &kernel, const SymbolTable &symbols) {
+    const auto lookup = codegen_cache.lookup(kernel, symbols);
+    if (not lookup.first.empty()) {
+        // In debug mode, we check that the cached source code is correct
+        #ifndef NDEBUG
+            stringstream ss;
+            writeKernel(kernel, symbols, {}, lookup.second, ss);
+            if (ss.str().compare(lookup.first) != 0) {
+                cout << "\nCached source code: \n" << lookup.first;
+                cout << "\nReal source code: \n" << ss.str();
+                assert(1 == 2);
+            }
+        #endif
+        return lookup;
+    }
+    const auto tcodegen = chrono::steady_clock::now();
+    stringstream ss;
+    writeKernel(kernel, symbols, {}, lookup.second, ss);
+    stat.time_codegen += chrono::steady_clock::now() - tcodegen;
+    codegen_cache.insert(ss.str(), lookup.second);
+    return make_pair(ss.str(), lookup.second);
+}
+
+KernelStats *EngineCPU::tierUp(const LoopB &kernel, vector<SymbolTable> &symbol_tables) {
+    // The unit of the tiered compilation is the generic kernel together with the strides and sizes of this execution
+    const SymbolTable &generic = symbol_tables.back();
+    util::Hasher hasher(CodegenCache::hash(kernel, generic));
+    for (int64_t size: generic.loopSizes()) {
+        hasher.add(size);
+    }
+    for (const bh_view *view: generic.offsetStrideViews()) {
+        hasher.add(view->start);
+        for (int64_t i = 0; i < view->ndim; ++i) {
+            hasher.add(view->stride[i]);
+        }
+    }
+    const uint64_t key = hasher.digest();
+    // NB: no kernel executes while the symbol tables are created thus we don't need `tier_mutex` here
+    KernelStats *kernel_stats = &tier_stats[key];
+    const bool hot = (tier_up_calls > 0 and kernel_stats->num_calls >= tier_up_calls) or
+                     (tier_up_seconds > 0 and kernel_stats->total_time.count() >= tier_up_seconds);
+    if (not hot or (generic.offsetStrideViews().empty() and generic.loopSizes().empty())) {
+        return kernel_stats;
+    }
+    if (not util::exist(tier_ready, key)) {
+        symbol_tables.emplace_back(kernel, use_volatile, false, index_as_var, const_as_var, false,
+                                   index_strength_reduce);
+        const auto source = getSource(kernel, symbol_tables.back());
+        symbol_tables.pop_back();
+        if (not tierReady(source.first, source.second)) {
+            return kernel_stats;
+        }
+        tier_ready.insert(key);
+    }
+    symbol_tables.pop_back();
+    symbol_tables.emplace_back(kernel, use_volatile, false, index_as_var, const_as_var, false, index_strength_reduce);
+    return kernel_stats;
+}
+
 void EngineCPU::handleExecution(BhIR *bhir) {
 
     const auto texecution = chrono::steady_clock::now();
@@ -64,56 +138,199 @@ void EngineCPU::handleExecution(BhIR *bhir) {
     // Let's get the kernel list
     vector<LoopB> kernel_list = get_kernel_list(instr_list, fusion_config, fcache, stat);
 
+    // Let's create the symbol tables and the source code of all kernels before executing any of them,
+    // which makes it possible for the engine to prepare (e.g. compile) all kernels at once.
+    // NB: we reserve `symbol_tables` upfront since a symbol table refers to its own members thus must not move.
+    //     The extra symbol table is used temporarily by `tierUp()`.
+    vector<SymbolTable> symbol_tables;
+    symbol_tables.reserve(kernel_list.size() + 1);
+    vector<const LoopB *> kernels;
+    vector<string> sources;
+    vector<uint64_t> codegen_hashes;
+    vector<KernelStats *> kernel_stats;
+    if (tier_stats.size() >= 65536) { // Kernels with ever changing strides never get hot, so we forget them
+        tier_stats.clear();
+        tier_ready.clear();
+    }
     for (const LoopB &kernel: kernel_list) {
-        // Let's create the symbol table for the kernel
-        const SymbolTable symbols(kernel,
-                                  use_volatile,
-                                  strides_as_var,
-                                  index_as_var,
-                                  const_as_var);
+        symbol_tables.emplace_back(kernel,
+                                   use_volatile,
+                                   strides_as_var,
+                                   index_as_var,
+                                   const_as_var,
+                                   shape_as_var,
+                                   index_strength_reduce);
+        if (kernel.isSystemOnly()) { // We can skip this step if the kernel does no computation
+            stat.record(symbol_tables.back());
+            continue;
+        }
+        if (tiered_compile) {
+            kernel_stats.push_back(tierUp(kernel, symbol_tables));
+        } else if (shape_as_var and
+                   specializeShape(CodegenCache::hash(kernel, symbol_tables.back()), symbol_tables.back())) {
+            // Kernels that keep executing with the same sizes get a variant where the sizes are literals
+            symbol_tables.pop_back();
+            symbol_tables.emplace_back(kernel,
+                                       use_volatile,
+                                       strides_as_var,
+                                       index_as_var,
+                                       const_as_var,
+                                       false,
+                                       index_strength_reduce);
+        }
+        const SymbolTable &symbols = symbol_tables.back();
         stat.record(symbols);
 
-        if (not kernel.isSystemOnly()) { // We can skip this step if the kernel does no computation
+        auto source = getSource(kernel, symbols);
+        kernels.push_back(&kernel);
+        sources.push_back(std::move(source.first));
+        codegen_hashes.push_back(source.second);
+    }
+    prepare(kernels, sources, codegen_hashes);
+
+    // Place the arrays that live only within this BhIR in one arena
+    MemoryPlan plan = memory_planner ? MemoryPlan(kernel_list, symbol_tables) : MemoryPlan();
+    plan.allocate();
+    stat.memory_plan_arrays += plan.numArrays();
+    if (plan.arrayBytes() > stat.memory_plan_array_bytes) {
+        stat.memory_plan_array_bytes = plan.arrayBytes();
+        stat.memory_plan_arena_bytes = plan.arenaBytes();
+    }
+
+    // NB: spilling needs the kernel order thus the kernels are executed sequentially when spilling is enabled
+    const bool spill = bh_spill_enabled();
+    if (task_scheduler and not spill) {
+        executeTaskParallel(kernel_list, symbol_tables, sources, codegen_hashes, kernel_stats, plan);
+        stat.time_total_execution += chrono::steady_clock::now() - texecution;
+        return;
+    }
+
+    // The kernels that use each array, which spilling uses to find the next use of an array
+    map<const bh_base *, vector<size_t> > uses;
+    if (spill) {
+        for (size_t i = 0; i < kernel_list.size(); ++i) {
+            for (const bh_base *base: symbol_tables[i].getParams()) {
+                uses[base].push_back(i);
+            }
+        }
+    }
+
+    size_t source_idx = 0;
+    for (size_t i = 0; i < kernel_list.size(); ++i) {
+        const LoopB &kernel = kernel_list[i];
+        const SymbolTable &symbols = symbol_tables[i];
+
+        if (not kernel.isSystemOnly()) {
+            if (spill) {
+                bh_spill_prepare(symbols.getParams(), [&uses, i](const bh_base *base) -> uint64_t {
+                    auto it = uses.find(base);
+                    if (it != uses.end()) {
+                        auto next = upper_bound(it->second.begin(), it->second.end(), i);
+                        if (next != it->second.end()) {
+                            return *next;
+                        }
+                    }
+                    return numeric_limits<uint64_t>::max();
+                });
+            }
             // Create the constant vector
             vector<const bh_instruction *> constants;
             constants.reserve(symbols.constIDs().size());
             for (const InstrPtr &instr: symbols.constIDs()) {
                 constants.push_back(&(*instr));
             }
-
-            const auto lookup = codegen_cache.lookup(kernel, symbols);
-            if (not lookup.first.empty()) {
-                // In debug mode, we check that the cached source code is correct
-                #ifndef NDEBUG
-                    stringstream ss;
-                    writeKernel(kernel, symbols, {}, lookup.second, ss);
-                    if (ss.str().compare(lookup.first) != 0) {
-                        cout << "\nCached source code: \n" << lookup.first;
-                        cout << "\nReal source code: \n" << ss.str();
-                        assert(1 == 2);
-                    }
-                #endif
-                execute(symbols, lookup.first, lookup.second, constants);
+            if (tiered_compile) {
+                // NB: we only time the execution, not the compilation
+                const auto launcher = getLauncher(kernel, symbols, sources[source_idx], codegen_hashes[source_idx],
+                                                  constants);
+                const auto texec = chrono::steady_clock::now();
+                launcher();
+                kernel_stats[source_idx]->register_exec_time(chrono::steady_clock::now() - texec);
             } else {
-                const auto tcodegen = chrono::steady_clock::now();
-                stringstream ss;
-                writeKernel(kernel, symbols, {}, lookup.second, ss);
-                string source = ss.str();
-                stat.time_codegen += chrono::steady_clock::now() - tcodegen;
-
-                execute(symbols, source, lookup.second, constants);
-                codegen_cache.insert(std::move(source), kernel, symbols);
+                execute(kernel, symbols, sources[source_idx], codegen_hashes[source_idx], constants);
             }
+            ++source_idx;
         }
 
         // Finally, let's cleanup
         for (bh_base *base: kernel.getAllFrees()) {
-            bh_data_free(base);
+            plan.free(base);
         }
     }
+    if (spill) {
+        bh_spill_prepare({});
+    }
+    plan.release();
     stat.time_total_execution += chrono::steady_clock::now() - texecution;
 }
 
+void EngineCPU::executeTaskParallel(const vector<LoopB> &kernel_list,
+                                    const vector<SymbolTable> &symbol_tables,
+                                    const vector<string> &sources,
+                                    const vector<uint64_t> &codegen_hashes,
+                                    const vector<KernelStats *> &kernel_stats,
+                                    MemoryPlan &plan) {
+    // The kernel DAG orders kernels that access the same arrays and kernels that free arrays used by other kernels
+    vector<vector<size_t> > predecessors(kernel_list.size());
+    {
+        vector<Block> block_list;
+        block_list.reserve(kernel_list.size());
+        for (const LoopB &kernel: kernel_list) {
+            block_list.emplace_back(kernel);
+        }
+        const graph::DAG dag = graph::from_block_list(block_list);
+        BOOST_FOREACH(const graph::Edge &e, boost::edges(dag)) {
+            predecessors[boost::target(e, dag)].push_back(boost::source(e, dag));
+        }
+        // A kernel must wait for the kernel that frees the arena bytes it reuses
+        for (const pair<size_t, size_t> &dep: plan.dependencies()) {
+            predecessors[dep.second].push_back(dep.first);
+        }
+    }
+
+    // The launchers are created in the original kernel order, which takes care of compilation.
+    // NB: the arrays of a kernel are allocated by its launcher thus not until the kernel is ready to run
+    vector<function<void()> > tasks;
+    tasks.reserve(kernel_list.size());
+    size_t source_idx = 0;
+    for (size_t i = 0; i < kernel_list.size(); ++i) {
+        const LoopB &kernel = kernel_list[i];
+        const SymbolTable &symbols = symbol_tables[i];
+
+        function<void()> launcher;
+        if (not kernel.isSystemOnly()) {
+            vector<const bh_instruction *> constants;
+            constants.reserve(symbols.constIDs().size());
+            for (const InstrPtr &instr: symbols.constIDs()) {
+                constants.push_back(&(*instr));
+            }
+            launcher = getLauncher(kernel, symbols, sources[source_idx], codegen_hashes[source_idx], constants);
+            if (tiered_compile) {
+                KernelStats *stats = kernel_stats[source_idx];
+                launcher = [this, launcher, stats]() {
+                    const auto texec = chrono::steady_clock::now();
+                    launcher();
+                    std::lock_guard<std::mutex> lock(tier_mutex);
+                    stats->register_exec_time(chrono::steady_clock::now() - texec);
+                };
+            }
+            ++source_idx;
+        }
+        tasks.emplace_back([this, launcher, &kernel, &plan]() {
+            if (launcher) {
+                limitTaskThreads(task_scheduler->numReadyTasks());
+                launcher();
+            }
+            std::lock_guard<std::mutex> lock(memory_mutex);
+            for (bh_base *base: kernel.getAllFrees()) {
+                plan.free(base);
+            }
+        });
+    }
+    task_scheduler->run(tasks, predecessors);
+    plan.release();
+}
+
 void EngineCPU::handleExtmethod(BhIR *bhir){
     std::vector<bh_instruction> instr_list;
 
@@ -18,6 +18,7 @@ GNU Lesser General Public License along with Bohrium.
 If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <iostream>
 #include <fstream>
 #include <numeric>
 #include <queue>
@@ -372,6 +373,21 @@ void fuser_reshapable_first(vector<Block> &block_list, bool avoid_rank0_sweep) {
 
 void fuser_greedy(const FusionConfig &config, vector<Block> &block_list) {
 
+    graph::DAG dag = graph::from_block_list(block_list);
+    graph::greedy(dag, config.avoid_rank0_sweep);
+    vector<Block> ret = graph::fill_block_list(dag);
+
+    // Let's fuse at the next rank level
+    for (Block &b: ret) {
+        if (not b.isInstr()) {
+            fuser_greedy(config, b.getLoop()._block_list);
+        }
+    }
+    block_list = ret;
+}
+
+void fuser_cost_model(const FusionConfig &config, vector<Block> &block_list) {
+
     graph::DAG dag = graph::from_block_list(block_list);
 
     if (boost::num_edges(dag) > config.greedy_threshold) {
@@ -379,13 +395,27 @@ void fuser_greedy(const FusionConfig &config, vector<Block> &block_list) {
         return;
     }
 
-    graph::greedy(dag, config.avoid_rank0_sweep);
+    const graph::CostModel model(config.cost_cache_size, config.cost_par_threshold, config.cost_serial_penalty,
+                                 config.cost_cache_penalty);
+    if (config.cost_benchmark and boost::num_edges(dag) > 0) {
+        graph::DAG greedy_dag = dag;
+        graph::greedy(greedy_dag, config.avoid_rank0_sweep);
+        graph::DAG cost_dag = dag;
+        graph::greedy_cost(cost_dag, config.avoid_rank0_sweep, model);
+        cout << "[fuser_cost_model] unfused: " << graph::total_cost(dag, model)
+             << ", greedy: " << graph::total_cost(greedy_dag, model) << " (" << boost::num_vertices(greedy_dag)
+             << " blocks), cost_model: " << graph::total_cost(cost_dag, model) << " ("
+             << boost::num_vertices(cost_dag) << " blocks)" << endl;
+        dag = std::move(cost_dag);
+    } else {
+        graph::greedy_cost(dag, config.avoid_rank0_sweep, model);
+    }
     vector<Block> ret = graph::fill_block_list(dag);
 
     // Let's fuse at the next rank level
     for (Block &b: ret) {
         if (not b.isInstr()) {
-            fuser_greedy(config, b.getLoop()._block_list);
+            fuser_cost_model(config, b.getLoop()._block_list);
         }
     }
     block_list = ret;
@@ -20,8 +20,14 @@ If not, see <http://www.gnu.org/licenses/>.
 
 #include <vector>
 #include <iostream>
+#include <unordered_map>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/archive_exception.hpp>
+#include <boost/serialization/vector.hpp>
 
 #include <bohrium/jitk/fuser_cache.hpp>
+#include <bohrium/jitk/codegen_util.hpp>
 
 
 using namespace std;
@@ -31,91 +37,74 @@ namespace jitk {
 
 namespace {
 
+// The structural hash of a view, which ignores the base array and the start
+uint64_t hash_structure(const bh_view &view) {
+    util::Hasher hasher;
+    hasher.add(view.ndim);
+    for (int64_t j = 0; j < view.ndim; ++j) {
+        hasher.add(view.shape[j]).add(view.stride[j]);
+    }
+    return hasher.digest();
+}
+
 // Handling view IDs
 class ViewDB {
 private:
-    size_t maxid;
-    std::map<bh_view,size_t> _map;
-public:
-    ViewDB() : maxid(0) {}
-
-    // Insert an object
-    std::pair<size_t,bool> insert(const bh_view &v) {
-        auto it = _map.find(v);
-        if (it == _map.end()) {
-            size_t id = maxid++;
-            _map.insert(std::make_pair(v,id));
-            return std::make_pair(id,true);
-
-        } else {
-            return  std::make_pair(it->second,false);
+    // A view and its hash, which the hash table uses as is
+    struct Key {
+        const bh_view *view;
+        uint64_t hash;
+        bool operator==(const Key &other) const {
+            return *view == *other.view;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            return static_cast<size_t>(key.hash);
         }
+    };
+    std::unordered_map<Key, size_t, KeyHash> _map;
+public:
+    // Insert a view and its structural hash, which must outlive the database
+    std::pair<size_t,bool> insert(const bh_view &v, uint64_t structure) {
+        const Key key{&v, util::Hasher(structure).add(reinterpret_cast<size_t>(v.base)).add(v.start).digest()};
+        const auto res = _map.insert(std::make_pair(key, _map.size()));
+        return std::make_pair(res.first->second, res.second);
     }
 };
 
+constexpr uint64_t SEP_INSTR = UINT64_MAX;
+constexpr uint64_t SEP_CONSTANT = UINT64_MAX - 3;
 
-constexpr size_t SEP_INSTR = SIZE_MAX;
-constexpr size_t SEP_OP = SIZE_MAX - 1;
-constexpr size_t SEP_SHAPE = SIZE_MAX - 2;
-constexpr size_t SEP_CONSTANT = SIZE_MAX - 3;
-
-/* The Instruction hash consists of the following fields:
- * <view_id><start><ndim>[<shape><stride><SEP_SHAPE>...]<SEP_OP>
+/* The View hash consists of the following fields:
+ * <view_id>[<start>]<hash_structure()>
  */
-void hash_view(const bh_view &view, ViewDB &views, std::stringstream &ss) {
+void hash_view(const bh_view &view, ViewDB &views, util::Hasher &hasher) {
     if (not view.isConstant()) {
-        size_t view_id = views.insert(view).first;
-        ss << view_id;
-        // Sliding views has identical hashes across iterations
-        if (not view.hasSlide()) {
-            ss << view.start;
-        } else {
-            // Check whether the shape of the sliding view is a single value
-            bool single_index = true;
-            for (int i = 0; i < view.ndim; i++) {
-                if (view.shape[i] != 1) {
-                    single_index = false;
-                    break;
-                }
-            }
-            if (!single_index) {
-                ss << view.start;
-            }
+        // NB: the structure is hashed once and used for both the view ID and the instruction hash
+        const uint64_t structure = hash_structure(view);
+        hasher.add(views.insert(view, structure).first);
+        // Sliding views has identical hashes across iterations thus we ignore the start of a sliding view
+        // unless the shape of the sliding view is a single value
+        if (not (view.hasSlide() and view.is_scalar())) {
+            hasher.add(view.start);
         }
-
-        ss << view.ndim;
-        for (int j = 0; j < view.ndim; ++j) {
-            ss << view.shape[j];
-            ss << view.stride[j];
-            ss << SEP_SHAPE;
-        }
-        ss << SEP_OP;
+        hasher.add(structure);
     } else {
         // Notice, we can ignore the value of the constant but we need to hash the location of the constant
-        ss << SEP_CONSTANT;
+        hasher.add(SEP_CONSTANT);
     }
 }
 
 /* The Instruction hash consists of the following fields:
- * <opcode[<hash_view>...]<sweep_axis()><SEP_INSTR>
+ * <opcode><number of operands>[<hash_view>...]<sweep_axis()><SEP_INSTR>
  */
-void hash_instr(const bh_instruction &instr, ViewDB &views, std::stringstream &ss) {
-    ss << instr.opcode; // <opcode>
+void hash_instr(const bh_instruction &instr, ViewDB &views, util::Hasher &hasher) {
+    hasher.add(instr.opcode).add(instr.operand.size());
     for(const bh_view &op: instr.operand) {
-        hash_view(op, views, ss);
-    }
-    ss << instr.sweep_axis();
-    ss << SEP_INSTR;
-}
-
-// Hash of an instruction list
-size_t hash_instr_list(const vector<bh_instruction *> &instr_list) {
-    stringstream ss;
-    ViewDB views;
-    for (const bh_instruction *instr: instr_list) {
-        hash_instr(*instr, views, ss);
+        hash_view(op, views, hasher);
     }
-    return util::hash(ss.str());
+    hasher.add(instr.sweep_axis()).add(SEP_INSTR);
 }
 
 // Replace the cached values of constants and bases arrays in `instr` with their original values
@@ -126,6 +115,8 @@ void update_with_origin(bh_instruction &instr, const bh_instruction *origin,
     for (size_t i = 0; i < instr.operand.size(); ++i) {
         if (instr.operand[i].hasSlide()) {
             instr.operand[i].start = origin->operand[i].start;
+            // NB: the cached slide belongs to an old BhIR
+            instr.operand[i].slides = origin->operand[i].slides;
         }
 
         if (instr.operand[i].isConstant()) {
@@ -177,13 +168,137 @@ std::vector<bh_base*> calc_base_ids(const vector<bh_instruction *> &instr_list)
     }
     return ret;
 }
+
+// The version of the file format of the persistent cache. Increase when changing the format.
+constexpr uint32_t PERSISTENT_VERSION = 3;
+
+/* Serialization of a block for the persistent cache.
+ * NB: base arrays are written as their address, which is only used as an ID by `update_with_origin()`
+ */
+template<class Archive>
+void save_block(Archive &ar, const Block &block) {
+    const bool is_instr = block.isInstr();
+    ar << is_instr;
+    if (is_instr) {
+        const bh_instruction &instr = *block.getInstr();
+        const int rank = block.rank();
+        // NB: the Boost serialization of `bh_instruction` doesn't include `origin_id` and `constructor`
+        ar << instr << instr.origin_id << instr.constructor << rank;
+    } else {
+        const LoopB &loop = block.getLoop();
+        const uint64_t num_blocks = loop._block_list.size();
+        ar << loop.rank << loop.size << num_blocks;
+        for (const Block &b: loop._block_list) {
+            save_block(ar, b);
+        }
+        vector<size_t> frees;
+        for (const bh_base *base: loop._frees) {
+            frees.push_back(reinterpret_cast<size_t>(base));
+        }
+        ar << frees;
+    }
+}
+
+// Deserialization of a block written by `save_block()`
+template<class Archive>
+Block load_block(Archive &ar) {
+    bool is_instr;
+    ar >> is_instr;
+    if (is_instr) {
+        bh_instruction instr;
+        int rank;
+        ar >> instr >> instr.origin_id >> instr.constructor >> rank;
+        return Block(instr, rank);
+    }
+    int rank;
+    int64_t size;
+    uint64_t num_blocks;
+    ar >> rank >> size >> num_blocks;
+    vector<Block> block_list;
+    block_list.reserve(num_blocks);
+    for (uint64_t i = 0; i < num_blocks; ++i) {
+        block_list.push_back(load_block(ar));
+    }
+    LoopB loop(rank, size, std::move(block_list));
+    vector<size_t> frees;
+    ar >> frees;
+    for (size_t base: frees) {
+        loop._frees.insert(reinterpret_cast<bh_base *>(base));
+    }
+    // NB: the rest of the metadata is updated by `update_with_origin()`
+    return Block(std::move(loop));
+}
 } // Anon namespace
 
-pair<vector<Block>, bool> FuseCache::get(const vector<bh_instruction *> &instr_list) {
-    const size_t lookup_hash = hash_instr_list(instr_list);
+uint64_t FuseCache::hash(const vector<bh_instruction *> &instr_list) {
+    util::Hasher hasher;
+    ViewDB views;
+    hasher.add(instr_list.size());
+    for (const bh_instruction *instr: instr_list) {
+        hash_instr(*instr, views, hasher);
+    }
+    return hasher.digest();
+}
+
+boost::filesystem::path FuseCache::persistentPath(size_t lookup_hash) const {
+    return _persistent_dir / hash_filename(_config_hash, lookup_hash, ".fuse");
+}
+
+map<size_t, FuseCache::CachePayload>::iterator FuseCache::loadPersistent(size_t lookup_hash) {
+    string data;
+    if (_persistent_dir.empty() or not read_file_mapped(persistentPath(lookup_hash), data)) {
+        return _cache.end();
+    }
+    CachePayload payload;
+    try {
+        stringstream ss(data);
+        boost::archive::binary_iarchive ia(ss);
+        uint32_t version;
+        ia >> version;
+        if (version != PERSISTENT_VERSION) {
+            return _cache.end();
+        }
+        vector<size_t> base_ids;
+        uint64_t num_blocks;
+        ia >> base_ids >> num_blocks;
+        for (size_t base: base_ids) {
+            payload.base_ids.push_back(reinterpret_cast<bh_base *>(base));
+        }
+        for (uint64_t i = 0; i < num_blocks; ++i) {
+            payload.block_list.push_back(load_block(ia));
+        }
+    } catch (const boost::archive::archive_exception &e) { // We ignore broken files
+        return _cache.end();
+    }
+    ++stat.fuser_cache_disk_hits;
+    return _cache.insert(make_pair(lookup_hash, std::move(payload))).first;
+}
+
+void FuseCache::storePersistent(size_t lookup_hash, const CachePayload &payload) const {
+    stringstream ss;
+    {
+        boost::archive::binary_oarchive oa(ss);
+        const uint64_t num_blocks = payload.block_list.size();
+        vector<size_t> base_ids;
+        for (const bh_base *base: payload.base_ids) {
+            base_ids.push_back(reinterpret_cast<size_t>(base));
+        }
+        oa << PERSISTENT_VERSION << base_ids << num_blocks;
+        for (const Block &block: payload.block_list) {
+            save_block(oa, block);
+        }
+    }
+    write_file_atomically(persistentPath(lookup_hash), ss.str());
+}
+
+pair<vector<Block>, bool> FuseCache::get(const vector<bh_instruction *> &instr_list, uint64_t lookup_hash) {
     ++stat.fuser_cache_lookups;
 
-    if (_cache.find(lookup_hash) != _cache.end()) { // Cache hit!
+    auto cached_payload = _cache.find(lookup_hash);
+    if (cached_payload == _cache.end()) {
+        cached_payload = loadPersistent(lookup_hash);
+    }
+    if (cached_payload != _cache.end()) { // Cache hit!
         // Create a map: 'origin_id' => instruction for updating the constants
         map<int64_t, const bh_instruction *> origin_id_to_instr;
         for(const bh_instruction *instr: instr_list) {
@@ -192,7 +307,7 @@ pair<vector<Block>, bool> FuseCache::get(const vector<bh_instruction *> &instr_l
             origin_id_to_instr.insert(make_pair(instr->origin_id, instr));
         }
         // Create a map: 'cached bases' => 'new bases' for updating the base arrays
-        const CachePayload &cached = _cache.at(lookup_hash);
+        const CachePayload &cached = cached_payload->second;
         std::map<bh_base*, bh_base*> base_cached2new;
         {
             size_t id = 0;
@@ -213,9 +328,11 @@ pair<vector<Block>, bool> FuseCache::get(const vector<bh_instruction *> &instr_l
     }
 }
 
-void FuseCache::insert(const vector<bh_instruction *> &instr_list, vector<Block> block_list) {
-    const size_t lookup_hash = hash_instr_list(instr_list);
+void FuseCache::insert(const vector<bh_instruction *> &instr_list, uint64_t lookup_hash, vector<Block> block_list) {
     CachePayload payload = {std::move(block_list), calc_base_ids(instr_list)};
+    if (not (_persistent_dir.empty() or _readonly)) {
+        storePersistent(lookup_hash, payload);
+    }
     _cache.insert(make_pair(lookup_hash, std::move(payload)));
 }
 
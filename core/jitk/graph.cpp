@@ -27,6 +27,7 @@ If not, see <http://www.gnu.org/licenses/>.
 #include <fstream>
 #include <numeric>
 #include <queue>
+#include <algorithm>
 #include <cassert>
 
 #include <bohrium/jitk/graph.hpp>
@@ -88,7 +89,7 @@ DAG from_block_list(const vector<Block> &block_list) {
     DAG graph;
     map<const bh_base*, set<Vertex> > base2vertices;
     for (const Block &block: block_list) {
-        assert(block.validation());
+        assert(block.rank() == -1 or block.validation()); // NB: kernels have rank -1
         Vertex vertex = boost::add_vertex(block, graph);
 
         // Find all vertices that must connect to 'vertex'
@@ -169,6 +170,58 @@ uint64_t block_cost(const Block &block) {
     return totalsize;
 }
 
+namespace {
+// Return the bytes that the views of non-temporary arrays in 'block' access. Unlike `block_cost()`, a view is
+// charged for the elements it accesses (ignoring broadcasted axes) rather than the size of its base array.
+uint64_t accessed_bytes(const Block &block) {
+    const set<bh_base *> temps = block.isInstr() ? set<bh_base *>() : block.getLoop().getAllTemps();
+    set<bh_view> views;
+    for (const InstrPtr &instr: bohrium::jitk::iterator::allInstr(block)) {
+        for (const bh_view &v: instr->getViews()) {
+            if (temps.find(v.base) == temps.end()) {
+                views.insert(v);
+            }
+        }
+    }
+    uint64_t totalsize = 0;
+    for (const bh_view &v: views) {
+        uint64_t nelem = 1;
+        for (int64_t i = 0; i < v.ndim; ++i) {
+            if (v.stride[i] != 0) {
+                nelem *= v.shape[i];
+            }
+        }
+        totalsize += nelem * bh_type_size(v.base->dtype());
+    }
+    return totalsize;
+}
+}
+
+double CostModel::cost(const Block &block) const {
+    const uint64_t traffic = accessed_bytes(block);
+    double ret = traffic;
+    if (block.isInstr()) {
+        return ret;
+    }
+    const LoopB &loop = block.getLoop();
+    if (parallel_ranks(loop).second < par_threshold) {
+        ret *= serial_penalty;
+    }
+    // The working set of one iteration of the block
+    if (loop.size > 0 and traffic / loop.size > cache_size) {
+        ret *= cache_penalty;
+    }
+    return ret;
+}
+
+double total_cost(const DAG &dag, const CostModel &model) {
+    double ret = 0;
+    BOOST_FOREACH(Vertex v, boost::vertices(dag)) {
+        ret += model.cost(dag[v]);
+    }
+    return ret;
+}
+
 bool validate(DAG &dag) {
     return true;
 }
@@ -316,51 +369,313 @@ void pprint(const DAG &dag, const char *filename, bool avoid_rank0_sweep, int id
     file.close();
 }
 
-void greedy(DAG &dag, bool avoid_rank0_sweep) {
-    while(1) {
-        // First we find all fusible edges
-        vector<Edge> fusibles;
-        {
-            auto edges = boost::edges(dag);
-            for (auto it = edges.first; it != edges.second;) {
-                Edge e = *it; ++it; // NB: we iterate here because boost::remove_edge() invalidates 'it'
-                Vertex v1 = source(e, dag);
-                Vertex v2 = target(e, dag);
-                // Remove transitive edges
-                if(path_exist(v1, v2, dag, true)) {
-                    boost::remove_edge(e, dag);
-                } else {
-                    const Block &b1 = dag[v1];
-                    const Block &b2 = dag[v2];
-                    if (mergeable(b1, b2, avoid_rank0_sweep)) {
-                        fusibles.push_back(e);
-                    }
+namespace {
+/* A DAG that supports incremental edge contraction, which `greedy()` uses.
+ * Merged vertices are marked dead rather than removed thus vertex ids are stable, and `order` is a topological order
+ * of the live vertices, which we maintain using the dynamic topological sort algorithm by Pearce and Kelly.
+ */
+class ContractibleDAG {
+    // Visit marks of the graph searches, a vertex `v` is visited when `_mark[v] == _stamp`
+    mutable vector<uint64_t> _mark;
+    mutable uint64_t _stamp = 0;
+
+    // Reorder the vertices when adding the edge 'x' -> 'y' where `order[y] < order[x]` (Pearce and Kelly)
+    void reorder(Vertex x, Vertex y) {
+        const uint64_t lb = order[y], ub = order[x];
+        // The vertices reachable from 'y' and the vertices that reach 'x' within the affected region
+        vector<Vertex> forward, backward;
+        vector<Vertex> stack = {y};
+        _mark[y] = ++_stamp;
+        while (not stack.empty()) {
+            const Vertex v = stack.back();
+            stack.pop_back();
+            forward.push_back(v);
+            for (Vertex c: children[v]) {
+                assert(c != x); // The new edge would introduce a cycle
+                if (_mark[c] != _stamp and order[c] < ub) {
+                    _mark[c] = _stamp;
+                    stack.push_back(c);
+                }
+            }
+        }
+        stack = {x};
+        _mark[x] = ++_stamp;
+        while (not stack.empty()) {
+            const Vertex v = stack.back();
+            stack.pop_back();
+            backward.push_back(v);
+            for (Vertex p: parents[v]) {
+                if (_mark[p] != _stamp and order[p] > lb) {
+                    _mark[p] = _stamp;
+                    stack.push_back(p);
                 }
             }
         }
-        // Any more vertices to fuse?
-        if (fusibles.size() == 0) {
-            break;
+        // Let's reuse the order slots of the affected vertices placing 'backward' before 'forward'
+        const auto by_order = [&](Vertex a, Vertex b) { return order[a] < order[b]; };
+        std::sort(forward.begin(), forward.end(), by_order);
+        std::sort(backward.begin(), backward.end(), by_order);
+        vector<uint64_t> slots;
+        slots.reserve(forward.size() + backward.size());
+        for (Vertex v: backward) {
+            slots.push_back(order[v]);
+        }
+        for (Vertex v: forward) {
+            slots.push_back(order[v]);
+        }
+        std::sort(slots.begin(), slots.end());
+        size_t i = 0;
+        for (Vertex v: backward) {
+            order[v] = slots[i++];
         }
+        for (Vertex v: forward) {
+            order[v] = slots[i++];
+        }
+    }
 
-        // Let's find the greatest weight edge.
-        Edge greatest = fusibles.front();
-        uint64_t greatest_weight = weight(dag[source(greatest, dag)], dag[target(greatest, dag)]);
-        for (Edge e: fusibles) {
-            const uint64_t w = weight(dag[source(e, dag)], dag[target(e, dag)]);
-            if (w > greatest_weight) {
-                greatest = e;
-                greatest_weight = w;
+public:
+    vector<Block> blocks;
+    vector<set<Vertex> > children, parents;
+    vector<bool> alive;
+    // Topological order of the live vertices
+    vector<uint64_t> order;
+    // Incremented whenever the block of a vertex changes
+    vector<uint64_t> version;
+
+    explicit ContractibleDAG(const DAG &dag) {
+        const size_t n = boost::num_vertices(dag);
+        _mark.resize(n, 0);
+        blocks.reserve(n);
+        BOOST_FOREACH(Vertex v, boost::vertices(dag)) {
+            blocks.push_back(dag[v]);
+        }
+        children.resize(n);
+        parents.resize(n);
+        BOOST_FOREACH(Edge e, boost::edges(dag)) {
+            children[source(e, dag)].insert(target(e, dag));
+            parents[target(e, dag)].insert(source(e, dag));
+        }
+        alive.resize(n, true);
+        version.resize(n, 0);
+        order.resize(n);
+        vector<Vertex> topological_order;
+        boost::topological_sort(dag, back_inserter(topological_order));
+        uint64_t i = 0;
+        BOOST_REVERSE_FOREACH(Vertex v, topological_order) {
+            order[v] = i++;
+        }
+    }
+
+    /* Determines whether there exist a path from 'a' to 'b' of length greater than one.
+     * Only vertices between 'a' and 'b' in the topological order can be on such a path.
+     */
+    bool long_path_exist(Vertex a, Vertex b) const {
+        vector<Vertex> stack;
+        ++_stamp;
+        for (Vertex c: children[a]) {
+            if (c != b and order[c] < order[b]) {
+                _mark[c] = _stamp;
+                stack.push_back(c);
             }
         }
-        Vertex v1 = source(greatest, dag);
-        Vertex v2 = target(greatest, dag);
-//        cout << "merge: " << v1 << ", " << v2 << endl;
+        while (not stack.empty()) {
+            const Vertex v = stack.back();
+            stack.pop_back();
+            for (Vertex c: children[v]) {
+                if (c == b) {
+                    return true;
+                }
+                if (_mark[c] != _stamp and order[c] < order[b]) {
+                    _mark[c] = _stamp;
+                    stack.push_back(c);
+                }
+            }
+        }
+        return false;
+    }
 
-        assert(not path_exist(v1, v2, dag, true)); // Transitive edges should have been removed by now
+    void remove_edge(Vertex a, Vertex b) {
+        children[a].erase(b);
+        parents[b].erase(a);
+    }
 
-        merge_vertices(dag, v1, v2, true);
+    // Merge vertices 'a' and 'b' (in that order) into 'a' (see `merge_vertices()`)
+    // NB: 'a' and 'b' MUST be fusible and no long path from 'a' to 'b' may exist
+    void merge(Vertex a, Vertex b) {
+        assert(alive[a] and alive[b]);
+        blocks[a] = reshape_and_merge(blocks[a].getLoop(), blocks[b].getLoop());
+        assert(blocks[a].validation());
+        ++version[a];
+        remove_edge(a, b);
+
+        // Add new children, which are all after 'b' thus after 'a' in the topological order
+        for (Vertex child: children[b]) {
+            parents[child].erase(b);
+            parents[child].insert(a);
+            children[a].insert(child);
+        }
+        // Add new parents, which might be after 'a' in the topological order
+        for (Vertex parent: parents[b]) {
+            children[parent].erase(b);
+            if (order[parent] > order[a]) {
+                reorder(parent, a);
+            }
+            children[parent].insert(a);
+            parents[a].insert(parent);
+        }
+        // Finally, cleanup of 'b'
+        alive[b] = false;
+        children[b].clear();
+        parents[b].clear();
+        blocks[b] = Block();
+    }
+
+    // Write the live vertices back into 'dag' in topological order
+    void fill_dag(DAG &dag) const {
+        vector<Vertex> live;
+        for (Vertex v = 0; v < alive.size(); ++v) {
+            if (alive[v]) {
+                live.push_back(v);
+            }
+        }
+        std::sort(live.begin(), live.end(), [&](Vertex a, Vertex b) { return order[a] < order[b]; });
+        DAG ret;
+        vector<Vertex> new_vertex(alive.size());
+        for (Vertex v: live) {
+            new_vertex[v] = boost::add_vertex(blocks[v], ret);
+        }
+        for (Vertex v: live) {
+            for (Vertex child: children[v]) {
+                boost::add_edge(new_vertex[v], new_vertex[child], ret);
+            }
+        }
+        dag = std::move(ret);
+    }
+};
+}
+
+void greedy(DAG &dag, bool avoid_rank0_sweep) {
+    ContractibleDAG graph(dag);
+
+    // A fusible edge and the versions of its vertices at the time its weight was calculated
+    struct Candidate {
+        uint64_t weight;
+        Vertex src, dst;
+        uint64_t src_version, dst_version;
+
+        // Heaviest first, ties are broken by the vertex ids
+        bool operator<(const Candidate &other) const {
+            if (weight != other.weight) {
+                return weight < other.weight;
+            }
+            return make_pair(src, dst) > make_pair(other.src, other.dst);
+        }
+    };
+    priority_queue<Candidate> queue;
+    const auto push = [&](Vertex src, Vertex dst) {
+        if (mergeable(graph.blocks[src], graph.blocks[dst], avoid_rank0_sweep)) {
+            queue.push({weight(graph.blocks[src], graph.blocks[dst]), src, dst,
+                        graph.version[src], graph.version[dst]});
+        }
+    };
+    for (Vertex v = 0; v < graph.blocks.size(); ++v) {
+        for (Vertex child: graph.children[v]) {
+            push(v, child);
+        }
+    }
+
+    while (not queue.empty()) {
+        const Candidate c = queue.top();
+        queue.pop();
+        // Candidates outdated by a merge have been pushed again with their new weight
+        if (not graph.alive[c.src] or not graph.alive[c.dst] or graph.version[c.src] != c.src_version or
+            graph.version[c.dst] != c.dst_version or graph.children[c.src].count(c.dst) == 0) {
+            continue;
+        }
+        // Transitive edges are redundant and cannot be merged
+        if (graph.long_path_exist(c.src, c.dst)) {
+            graph.remove_edge(c.src, c.dst);
+            continue;
+        }
+        graph.merge(c.src, c.dst);
+        for (Vertex parent: graph.parents[c.src]) {
+            push(parent, c.src);
+        }
+        for (Vertex child: graph.children[c.src]) {
+            push(c.src, child);
+        }
+    }
+    graph.fill_dag(dag);
+    assert(validate(dag));
+}
+
+void greedy_cost(DAG &dag, bool avoid_rank0_sweep, const CostModel &model) {
+    ContractibleDAG graph(dag);
+    vector<double> cost(graph.blocks.size());
+    for (Vertex v = 0; v < graph.blocks.size(); ++v) {
+        cost[v] = model.cost(graph.blocks[v]);
+    }
+
+    // A fusible edge that doesn't increase the cost and the versions of its vertices at the time its gain was
+    // calculated (see `greedy()`)
+    struct Candidate {
+        double gain;
+        uint64_t weight;
+        Vertex src, dst;
+        uint64_t src_version, dst_version;
+
+        // Largest cost reduction first, ties are broken by the bytes of temporaries eliminated and the vertex ids
+        bool operator<(const Candidate &other) const {
+            if (gain != other.gain) {
+                return gain < other.gain;
+            }
+            if (weight != other.weight) {
+                return weight < other.weight;
+            }
+            return make_pair(src, dst) > make_pair(other.src, other.dst);
+        }
+    };
+    priority_queue<Candidate> queue;
+    const auto push = [&](Vertex src, Vertex dst) {
+        const Block &b1 = graph.blocks[src];
+        const Block &b2 = graph.blocks[dst];
+        if (mergeable(b1, b2, avoid_rank0_sweep)) {
+            const double gain = cost[src] + cost[dst] - model.cost(reshape_and_merge(b1.getLoop(), b2.getLoop()));
+            if (gain >= 0) {
+                queue.push({gain, weight(b1, b2), src, dst, graph.version[src], graph.version[dst]});
+            }
+        }
+    };
+    for (Vertex v = 0; v < graph.blocks.size(); ++v) {
+        for (Vertex child: graph.children[v]) {
+            push(v, child);
+        }
+    }
+
+    while (not queue.empty()) {
+        const Candidate c = queue.top();
+        queue.pop();
+        // Candidates outdated by a merge have been pushed again with their new gain
+        if (not graph.alive[c.src] or not graph.alive[c.dst] or graph.version[c.src] != c.src_version or
+            graph.version[c.dst] != c.dst_version or graph.children[c.src].count(c.dst) == 0) {
+            continue;
+        }
+        // Transitive edges are redundant and cannot be merged
+        if (graph.long_path_exist(c.src, c.dst)) {
+            graph.remove_edge(c.src, c.dst);
+            continue;
+        }
+        graph.merge(c.src, c.dst);
+        cost[c.src] = model.cost(graph.blocks[c.src]);
+        // Only the edges adjacent to the merged vertex change their gain
+        for (Vertex parent: graph.parents[c.src]) {
+            push(parent, c.src);
+        }
+        for (Vertex child: graph.children[c.src]) {
+            push(c.src, child);
+        }
     }
+    graph.fill_dag(dag);
     assert(validate(dag));
 }
 
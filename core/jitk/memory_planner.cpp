@@ -0,0 +1,147 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cassert>
+#include <algorithm>
+
+#include <bohrium/bh_main_memory.hpp>
+#include <bohrium/bh_util.hpp>
+#include <bohrium/jitk/memory_planner.hpp>
+
+using namespace std;
+
+namespace bohrium {
+namespace jitk {
+
+namespace {
+// Do the live ranges of 'a' and 'b' overlap (both ends included)
+template<typename T>
+bool live_ranges_overlap(const T &a, const T &b) {
+    return a.first_kernel <= b.free_kernel and b.first_kernel <= a.free_kernel;
+}
+
+// Do the arena bytes of 'a' and 'b' overlap
+template<typename T>
+bool bytes_overlap(const T &a, const T &b) {
+    return a.offset < b.offset + b.nbytes and b.offset < a.offset + a.nbytes;
+}
+}
+
+MemoryPlan::MemoryPlan(const vector<LoopB> &kernel_list, const vector<SymbolTable> &symbol_tables,
+                       uint64_t alignment) {
+    assert(kernel_list.size() == symbol_tables.size());
+
+    // Find the live range of the arrays that aren't allocated yet
+    map<bh_base *, size_t> first_use;
+    for (size_t i = 0; i < kernel_list.size(); ++i) {
+        for (bh_base *base: symbol_tables[i].getParams()) {
+            if (base->getDataPtr() == nullptr and not util::exist(first_use, base)) {
+                first_use[base] = i;
+            }
+        }
+        for (bh_base *base: kernel_list[i].getAllFrees()) {
+            auto it = first_use.find(base);
+            if (it != first_use.end() and base->nbytes() > 0) {
+                Placement &p = _placements[base];
+                p.first_kernel = it->second;
+                p.free_kernel = i;
+                p.offset = 0;
+                p.nbytes = (base->nbytes() + alignment - 1) / alignment * alignment;
+                _array_bytes += base->nbytes();
+            }
+        }
+    }
+
+    // Greedy by size: the largest arrays are placed first at the lowest offset that doesn't overlap
+    // the arrays already placed with an overlapping live range
+    vector<pair<bh_base *, Placement *> > order;
+    for (auto &p: _placements) {
+        order.emplace_back(p.first, &p.second);
+    }
+    stable_sort(order.begin(), order.end(), [](const pair<bh_base *, Placement *> &a,
+                                               const pair<bh_base *, Placement *> &b) {
+        return a.second->nbytes > b.second->nbytes;
+    });
+    uint64_t arena_size = 0;
+    vector<const Placement *> placed;
+    for (auto &p: order) {
+        Placement &cur = *p.second;
+        vector<const Placement *> live;
+        for (const Placement *other: placed) {
+            if (live_ranges_overlap(cur, *other)) {
+                live.push_back(other);
+            }
+        }
+        sort(live.begin(), live.end(), [](const Placement *a, const Placement *b) {
+            return a->offset < b->offset;
+        });
+        cur.offset = 0;
+        for (const Placement *other: live) {
+            if (bytes_overlap(cur, *other)) {
+                cur.offset = other->offset + other->nbytes;
+            }
+        }
+        arena_size = max(arena_size, cur.offset + cur.nbytes);
+        placed.push_back(&cur);
+    }
+    _arena = bh_base(static_cast<int64_t>(arena_size), bh_type::UINT8);
+}
+
+MemoryPlan::~MemoryPlan() {
+    release();
+}
+
+void MemoryPlan::allocate() {
+    if (_placements.empty()) {
+        return;
+    }
+    bh_data_malloc(&_arena);
+    char *arena = static_cast<char *>(_arena.getDataPtr());
+    for (auto &p: _placements) {
+        p.first->resetDataPtr(arena + p.second.offset);
+    }
+}
+
+void MemoryPlan::free(bh_base *base) {
+    if (util::exist(_placements, base)) {
+        base->resetDataPtr();
+    } else {
+        bh_data_free(base);
+    }
+}
+
+void MemoryPlan::release() {
+    bh_data_free(&_arena);
+}
+
+vector<pair<size_t, size_t> > MemoryPlan::dependencies() const {
+    vector<pair<size_t, size_t> > ret;
+    for (const auto &a: _placements) {
+        for (const auto &b: _placements) {
+            if (a.second.free_kernel < b.second.first_kernel and bytes_overlap(a.second, b.second)) {
+                ret.emplace_back(a.second.free_kernel, b.second.first_kernel);
+            }
+        }
+    }
+    return ret;
+}
+
+} // jitk
+} // bohrium
@@ -38,5 +38,16 @@ Scope::writeIdxDeclaration(const bh_view &view, const std::string &type_str, int
     _declared_idx.insert(view);
 }
 
+void Scope::writePartialIdxDeclaration(const bh_view &view, int rank, const std::string &type_str,
+                                       std::stringstream &out) {
+    assert(not isPartialIdxDeclared(view, rank));
+    out << "const " << type_str << " ";
+    getPartialIdxName(view, rank, out);
+    out << " = (";
+    write_array_partial_index(*this, view, rank, out);
+    out << ");";
+    _partial_idx.insert(std::make_pair(symbols.offsetStridesID(view), rank));
+}
+
 } // jitk
 } // bohrium
@@ -18,6 +18,8 @@ GNU Lesser General Public License along with Bohrium.
 If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <functional>
+
 #include <bohrium/bh_util.hpp>
 #include <bohrium/jitk/symbol_table.hpp>
 #include <bohrium/jitk/view.hpp>
@@ -32,11 +34,15 @@ SymbolTable::SymbolTable(const LoopB &kernel,
                          bool use_volatile,
                          bool strides_as_var,
                          bool index_as_var,
-                         bool const_as_var) : _useRandom(false),
+                         bool const_as_var,
+                         bool shape_as_var,
+                         bool index_strength_reduce) : _useRandom(false),
                                               use_volatile(use_volatile),
                                               strides_as_var(strides_as_var),
                                               index_as_var(index_as_var),
-                                              const_as_var(const_as_var) {
+                                              const_as_var(const_as_var),
+                                              shape_as_var(shape_as_var),
+                                              index_strength_reduce(index_strength_reduce) {
 
     // NB: by assigning the IDs in the order they appear in the 'instr_list',
     //     the kernels can better be reused
@@ -49,6 +55,11 @@ SymbolTable::SymbolTable(const LoopB &kernel,
             }
             _offset_strides_map.insert(std::make_pair(view, _offset_strides_map.size()));
         }
+        if (instr->opcode == BH_RANGE) {
+            // NB: the range is the array index of a view of its own (see `range_index_view()`)
+            _offset_strides_map.insert(std::make_pair(range_index_view(instr->operand[0]),
+                                                      _offset_strides_map.size()));
+        }
         if (const_as_var) {
             assert(instr->origin_id >= 0);
             if (instr->has_constant()) {
@@ -90,6 +101,19 @@ SymbolTable::SymbolTable(const LoopB &kernel,
             }
         }
     }
+    if (shape_as_var) {
+        // NB: the IDs are assigned depth-first thus they only depend on the structure of the kernel
+        std::function<void(const LoopB &)> assign_ids = [&](const LoopB &loop) {
+            for (const Block &b: loop._block_list) {
+                if (not b.isInstr()) {
+                    _loop_size_map.insert(std::make_pair(&b.getLoop(), _loop_sizes.size()));
+                    _loop_sizes.push_back(b.getLoop().size);
+                    assign_ids(b.getLoop());
+                }
+            }
+        };
+        assign_ids(kernel);
+    }
     if (strides_as_var) {
         _offset_stride_views.resize(_offset_strides_map.size());
         for (auto &v: _offset_strides_map) {
@@ -0,0 +1,187 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include <bohrium/jitk/task_scheduler.hpp>
+
+using namespace std;
+
+namespace bohrium {
+namespace jitk {
+
+TaskScheduler::TaskScheduler(size_t num_threads) {
+    if (num_threads == 0) {
+        throw runtime_error("TaskScheduler: the number of threads must be greater than zero");
+    }
+    for (size_t i = 0; i < num_threads; ++i) {
+        _workers.emplace_back(new Worker());
+    }
+    for (size_t i = 0; i < num_threads; ++i) {
+        _threads.emplace_back(&TaskScheduler::workerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv_work.notify_all();
+    for (std::thread &thread: _threads) {
+        thread.join();
+    }
+}
+
+void TaskScheduler::push(size_t worker_id, size_t task) {
+    {
+        Worker &worker = *_workers[worker_id];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queue.push_back(task);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_num_queued;
+    }
+    _cv_work.notify_one();
+}
+
+bool TaskScheduler::pop(size_t worker_id, size_t &task) {
+    bool found = false;
+    {
+        Worker &worker = *_workers[worker_id];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (not worker.queue.empty()) {
+            task = worker.queue.back();
+            worker.queue.pop_back();
+            found = true;
+        }
+    }
+    // Let's try to steal from the other workers
+    for (size_t i = 1; not found and i < _workers.size(); ++i) {
+        Worker &victim = *_workers[(worker_id + i) % _workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (not victim.queue.empty()) {
+            task = victim.queue.front();
+            victim.queue.pop_front();
+            found = true;
+        }
+    }
+    if (found) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        --_num_queued;
+    }
+    return found;
+}
+
+void TaskScheduler::execute(size_t worker_id, size_t task) {
+    bool failed;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        failed = static_cast<bool>(_error);
+        ++_num_running;
+    }
+    if (not failed) {
+        try {
+            (*_tasks)[task]();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (not _error) {
+                _error = std::current_exception();
+            }
+        }
+    }
+    // NB: the successors of a failed task are still pushed (but skipped) thus `run()` always finishes
+    for (size_t successor: _successors[task]) {
+        if (--_num_predecessors[successor] == 0) {
+            push(worker_id, successor);
+        }
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    --_num_running;
+    if (--_remaining == 0) {
+        _cv_done.notify_all();
+    }
+}
+
+void TaskScheduler::workerLoop(size_t worker_id) {
+    while (true) {
+        size_t task;
+        if (pop(worker_id, task)) {
+            execute(worker_id, task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv_work.wait(lock, [&] { return _stop or _num_queued > 0; });
+        if (_stop) {
+            return;
+        }
+    }
+}
+
+size_t TaskScheduler::numReadyTasks() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return std::min(_num_running + _num_queued, _threads.size());
+}
+
+void TaskScheduler::run(const vector<function<void()> > &tasks, const vector<vector<size_t> > &predecessors) {
+    assert(tasks.size() == predecessors.size());
+    if (tasks.empty()) {
+        return;
+    }
+    _tasks = &tasks;
+    _successors.assign(tasks.size(), {});
+    _num_predecessors.reset(new std::atomic<size_t>[tasks.size()]);
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        _num_predecessors[i] = predecessors[i].size();
+        for (size_t p: predecessors[i]) {
+            assert(p < tasks.size());
+            _successors[p].push_back(i);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _remaining = tasks.size();
+        _error = nullptr;
+    }
+    // The ready tasks are distributed round-robin
+    size_t worker_id = 0;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        if (predecessors[i].empty()) {
+            push(worker_id, i);
+            worker_id = (worker_id + 1) % _workers.size();
+        }
+    }
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv_done.wait(lock, [&] { return _remaining == 0; });
+        error = _error;
+    }
+    _tasks = nullptr;
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // jitk
+} // bohrium
@@ -18,6 +18,11 @@ GNU Lesser General Public License along with Bohrium.
 If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <unistd.h>
+#include <cstdlib>
+#include <algorithm>
+
+#include <bohrium/bh_util.hpp>
 #include <bohrium/jitk/transformer.hpp>
 #include <bohrium/jitk/iterator.hpp>
 
@@ -122,6 +127,351 @@ bool collapse_instr_axes(LoopB &loop, const int axis) {
     return true;
 }
 
+// The size of a cache line in bytes
+constexpr int64_t CACHE_LINE = 64;
+
+// Help function that returns the size of the L1 data cache of the CPU
+uint64_t l1_cache_size() {
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    const long size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    if (size > 0) {
+        return static_cast<uint64_t>(size);
+    }
+#endif
+    return 32 * 1024;
+}
+
+// Help function that returns the size of the L2 cache of the CPU
+uint64_t l2_cache_size() {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    const long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (size > 0) {
+        return static_cast<uint64_t>(size);
+    }
+#endif
+    return 256 * 1024;
+}
+
+// Help function that returns the instructions of 'loop' when it is a perfect loop nest of element-wise
+// instructions, i.e. each loop has exactly one child loop except the innermost loop, which only has instructions.
+// Set 'allow_reductions' to also accept reductions, which the loops may be reordered around.
+// Returns an empty vector when 'loop' isn't a perfect loop nest.
+vector<InstrPtr> perfect_nest_instrs(const LoopB &loop, bool allow_reductions = false) {
+    const LoopB *innermost = &loop;
+    while (not innermost->_block_list.empty() and not innermost->_block_list[0].isInstr()) {
+        if (innermost->_block_list.size() != 1 or not (allow_reductions or innermost->_sweeps.empty())) {
+            return {};
+        }
+        innermost = &innermost->_block_list[0].getLoop();
+    }
+    if (not (allow_reductions or innermost->_sweeps.empty())) {
+        return {};
+    }
+    vector<InstrPtr> ret;
+    const int ndim = innermost->rank + 1;
+    for (const Block &b: innermost->_block_list) {
+        if (not b.isInstr()) {
+            return {};
+        }
+        const InstrPtr &instr = b.getInstr();
+        const bool reduction = bh_opcode_is_reduction(instr->opcode);
+        // NB: the order of the iterations changes thus we only allow instructions that access arrays element-wise
+        if (bh_opcode_is_system(instr->opcode) or (bh_opcode_is_sweep(instr->opcode) and not
+                                                   (allow_reductions and reduction)) or
+            instr->opcode == BH_GATHER or instr->opcode == BH_SCATTER or instr->opcode == BH_COND_SCATTER) {
+            return {};
+        }
+        for (size_t o = 0; o < instr->operand.size(); ++o) {
+            const bh_view &view = instr->operand[o];
+            if (not view.isConstant() and view.ndim != ((o == 0 and reduction) ? ndim - 1 : ndim)) {
+                return {};
+            }
+        }
+        ret.push_back(instr);
+    }
+    return ret;
+}
+
+// Help function that returns the number of bytes of the cache lines one iteration of 'axis' touches when
+// iterating the axis 'axis+1' of 'views' 'size' times
+uint64_t row_footprint(const set<bh_view> &views, int axis, int64_t size) {
+    uint64_t ret = 0;
+    for (const bh_view &view: views) {
+        const int64_t stride = std::abs(view.stride[axis + 1]) * bh_type_size(view.base->dtype());
+        ret += size * std::min(stride, CACHE_LINE);
+    }
+    return ret;
+}
+
+// Help function that returns the number of bytes of the cache lines a `tile` times `tile` tile of the axes
+// 'axis' and 'axis+1' of 'views' touches
+uint64_t tile_footprint(const set<bh_view> &views, int axis, int64_t tile) {
+    uint64_t ret = 0;
+    for (const bh_view &view: views) {
+        const int64_t elem = bh_type_size(view.base->dtype());
+        const int64_t s1 = std::abs(view.stride[axis]) * elem;
+        const int64_t s2 = std::abs(view.stride[axis + 1]) * elem;
+        const int64_t lo = std::min(s1, s2);
+        const int64_t hi = std::max(s1, s2);
+        if (hi == 0) { // The same element throughout the tile
+            ret += CACHE_LINE;
+        } else if (lo == 0) { // One row of the tile
+            ret += tile * std::min(hi, CACHE_LINE);
+        } else if (lo >= CACHE_LINE) { // Each element has its own cache line
+            ret += tile * tile * CACHE_LINE;
+        } else { // The tile consists of `tile` rows along the axis of the smallest stride
+            ret += tile * std::max(tile * lo, CACHE_LINE);
+        }
+    }
+    return ret;
+}
+
+// Help function that returns the largest power of two tile of at least 8 and at most 'max_tile' whose footprint
+// fits in 'cache_size' bytes or 0 when no such tile exists
+int64_t fit_tile(const set<bh_view> &views, int axis, int64_t max_tile, uint64_t cache_size) {
+    int64_t ret = 0;
+    for (int64_t tile = 8; tile <= max_tile and tile_footprint(views, axis, tile) <= cache_size; tile *= 2) {
+        ret = tile;
+    }
+    return ret;
+}
+
+// Help function that restricts the axes 'axis' and 'axis+1' of 'view' to [begin1, end1) and [begin2, end2)
+void slice_view(bh_view &view, int axis, int64_t begin1, int64_t end1, int64_t begin2, int64_t end2) {
+    view.start += begin1 * view.stride[axis] + begin2 * view.stride[axis + 1];
+    view.shape[axis] = end1 - begin1;
+    view.shape[axis + 1] = end2 - begin2;
+}
+
+// Help function that splits the axes 'axis' and 'axis+1' of 'view' into a pair of axes for each tile in 'tiles'
+// followed by two intra-tile axes. The tiles go from the outermost to the innermost and each tile must divide the
+// tile before it and the sizes of both axes.
+void tile_view(bh_view &view, int axis, const vector<int64_t> &tiles) {
+    const int64_t size1 = view.shape[axis], size2 = view.shape[axis + 1];
+    const int64_t stride1 = view.stride[axis], stride2 = view.stride[axis + 1];
+    const auto nlevels = static_cast<int64_t>(tiles.size());
+    view.shape.resize(static_cast<size_t>(view.ndim + 2 * nlevels));
+    view.stride.resize(static_cast<size_t>(view.ndim + 2 * nlevels));
+    // NB: we move the axes after the two tiled axes to the end
+    for (int64_t i = view.ndim - 1; i >= axis + 2; --i) {
+        view.shape[i + 2 * nlevels] = view.shape[i];
+        view.stride[i + 2 * nlevels] = view.stride[i];
+    }
+    view.ndim += 2 * nlevels;
+    int64_t outer1 = size1, outer2 = size2;
+    for (int64_t level = 0; level <= nlevels; ++level) {
+        const int64_t tile = level < nlevels ? tiles[level] : 1;
+        view.shape[axis + 2 * level] = outer1 / tile;
+        view.shape[axis + 2 * level + 1] = outer2 / tile;
+        view.stride[axis + 2 * level] = stride1 * tile;
+        view.stride[axis + 2 * level + 1] = stride2 * tile;
+        outer1 = outer2 = tile;
+    }
+}
+
+// Help function that splits the element-wise instructions of a loop nest into pieces where the first piece
+// iterates the largest part of the axes 'axis' and 'axis+1' that 'tiles[0]' divides in tiles (see `tile_view()`)
+// and the remaining pieces iterate the remainders of the two axes. The remainders are tiled by the inner tiles.
+// Each piece is a list of instructions that make up a loop nest.
+vector<vector<InstrPtr> > tile_instrs(const vector<InstrPtr> &instr_list, int axis, const vector<int64_t> &tiles) {
+    const BhIntVec shape = instr_list[0]->shape();
+    const int64_t size1 = shape[axis], size2 = shape[axis + 1];
+    const int64_t tile = tiles.empty() ? 0 : tiles[0];
+    if (tile == 0 or size1 < tile or size2 < tile) {
+        return {instr_list};
+    }
+    const int64_t main1 = size1 - size1 % tile, main2 = size2 - size2 % tile;
+
+    // Returns the instructions restricted to [begin1, end1) and [begin2, end2), which are tiled when 'tiled'
+    auto slice = [&](int64_t begin1, int64_t end1, int64_t begin2, int64_t end2, bool tiled) {
+        vector<InstrPtr> ret;
+        for (const InstrPtr &instr: instr_list) {
+            bh_instruction tmp(*instr);
+            for (bh_view &view: tmp.operand) {
+                if (not view.isConstant()) {
+                    slice_view(view, axis, begin1, end1, begin2, end2);
+                    if (tiled) {
+                        tile_view(view, axis, tiles);
+                    }
+                }
+            }
+            ret.push_back(std::make_shared<bh_instruction>(tmp));
+        }
+        return ret;
+    };
+
+    vector<vector<InstrPtr> > ret = {slice(0, main1, 0, main2, true)};
+    const vector<int64_t> inner_tiles(tiles.begin() + 1, tiles.end());
+    if (main2 < size2) {
+        for (auto &piece: tile_instrs(slice(0, main1, main2, size2, false), axis, inner_tiles)) {
+            ret.push_back(std::move(piece));
+        }
+    }
+    if (main1 < size1) {
+        for (auto &piece: tile_instrs(slice(main1, size1, 0, size2, false), axis, inner_tiles)) {
+            ret.push_back(std::move(piece));
+        }
+    }
+    return ret;
+}
+
+// Help function that tiles the two innermost axes of 'loop' if it is a perfect loop nest that accesses an array
+// across cache lines along the innermost axis and reuses the cache lines along the axis before it.
+// The tiles fit in the L1 cache and, when an iteration of the axis before the innermost doesn't fit in the L2 cache
+// either, they are grouped in tiles that fit in the L2 cache.
+// Returns the loop nests that replace 'loop' or an empty vector when 'loop' wasn't tiled.
+vector<Block> tile_loop(const LoopB &loop, uint64_t l1_size, uint64_t l2_size) {
+    const vector<InstrPtr> instr_list = perfect_nest_instrs(loop);
+    if (instr_list.empty()) {
+        return {};
+    }
+    const BhIntVec shape = instr_list[0]->shape();
+    const int ndim = static_cast<int>(shape.size());
+    const int axis = ndim - 2;
+    if (ndim < 2 or ndim + 2 > BH_MAXDIM) {
+        return {};
+    }
+
+    // Tiling only pays off when an array is read across cache lines along the innermost axis and the cache lines
+    // of one iteration of the axis before it doesn't fit in the cache
+    set<bh_view> views;
+    bool transposed = false;
+    for (const InstrPtr &instr: instr_list) {
+        for (const bh_view &view: instr->getViews()) {
+            const int64_t elem = bh_type_size(view.base->dtype());
+            if (std::abs(view.stride[axis + 1]) * elem >= CACHE_LINE and
+                std::abs(view.stride[axis]) < std::abs(view.stride[axis + 1])) {
+                transposed = true;
+            }
+            views.insert(view);
+        }
+    }
+    const uint64_t row_bytes = row_footprint(views, axis, shape[axis + 1]);
+    if (not transposed or row_bytes <= l1_size) {
+        return {};
+    }
+
+    // We use the largest power of two tiles that fit in the caches. The remainders of the axes are tiled by the
+    // inner tiles and the remainders of the innermost tiles are not tiled.
+    const int64_t max_tile = std::min(shape[axis], shape[axis + 1]);
+    const int64_t l1_tile = fit_tile(views, axis, max_tile, l1_size);
+    if (l1_tile == 0) {
+        return {};
+    }
+    vector<int64_t> tiles = {l1_tile};
+    if (row_bytes > l2_size and ndim + 4 <= BH_MAXDIM) {
+        const int64_t l2_tile = fit_tile(views, axis, max_tile, l2_size);
+        if (l2_tile > l1_tile) {
+            tiles.insert(tiles.begin(), l2_tile);
+        }
+    }
+
+    // Every nest gets the frees of the arrays it creates, which are temporary arrays to all of the nests,
+    // and the last nest gets the remaining frees
+    const set<bh_base *> frees = loop.getAllFrees();
+    set<bh_base *> temps;
+    for (const InstrPtr &instr: instr_list) {
+        if (instr->constructor and util::exist(frees, instr->operand[0].base)) {
+            temps.insert(instr->operand[0].base);
+        }
+    }
+    vector<Block> ret;
+    const vector<vector<InstrPtr> > pieces = tile_instrs(instr_list, axis, tiles);
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        ret.push_back(create_nested_block(pieces[i], loop.rank, i + 1 == pieces.size() ? frees : temps));
+    }
+    return ret;
+}
+
+// Help function that returns the stride of 'axis' of the instruction principal shape in operand 'o' of 'instr'.
+// NB: the output of a reduction doesn't have the reduced axis thus its stride is zero
+int64_t principal_stride(const bh_instruction &instr, size_t o, int axis) {
+    const bh_view &view = instr.operand[o];
+    if (o == 0 and bh_opcode_is_reduction(instr.opcode)) {
+        const int sa = instr.sweep_axis();
+        if (axis == sa) {
+            return 0;
+        }
+        return view.stride[axis < sa ? axis : axis - 1];
+    }
+    return view.stride[axis];
+}
+
+// Help function that reorders the loops of 'loop' such that the axes with the smallest strides (in bytes, summed
+// over all operands where writes count double) become the innermost loops, if it is a perfect loop nest.
+// The outermost loop is kept when the new outermost loop would sweep or have less than 'min_threading' iterations.
+// Returns true when the loops were reordered.
+bool interchange_loop(LoopB &loop, uint64_t min_threading) {
+    const vector<InstrPtr> instr_list = perfect_nest_instrs(loop, true);
+    if (instr_list.empty()) {
+        return false;
+    }
+    const BhIntVec shape = instr_list[0]->shape();
+    const int ndim = static_cast<int>(shape.size());
+    if (ndim < 2) {
+        return false;
+    }
+
+    // The stride cost of each axis
+    vector<uint64_t> cost(static_cast<size_t>(ndim), 0);
+    set<int> sweep_axes;
+    for (const InstrPtr &instr: instr_list) {
+        if (bh_opcode_is_sweep(instr->opcode)) {
+            sweep_axes.insert(instr->sweep_axis());
+        }
+        for (size_t o = 0; o < instr->operand.size(); ++o) {
+            if (instr->operand[o].isConstant()) {
+                continue;
+            }
+            const uint64_t elem = bh_type_size(instr->operand[o].base->dtype());
+            const uint64_t weight = o == 0 ? 2 : 1;
+            for (int axis = 0; axis < ndim; ++axis) {
+                cost[axis] += std::abs(principal_stride(*instr, o, axis)) * elem * weight;
+            }
+        }
+    }
+    vector<int> order(static_cast<size_t>(ndim));
+    for (int axis = 0; axis < ndim; ++axis) {
+        order[axis] = axis;
+    }
+    std::stable_sort(order.begin(), order.end(), [&cost](int a, int b) { return cost[a] > cost[b]; });
+
+    // We keep the parallelism of the outermost loop
+    const int64_t min_size = std::min(shape[0], static_cast<int64_t>(min_threading));
+    const int outermost = order[0];
+    const int original_outermost = 0;
+    if (outermost != original_outermost and
+        ((util::exist(sweep_axes, outermost) and not util::exist(sweep_axes, original_outermost)) or
+         shape[outermost] < min_size)) {
+        order.erase(std::find(order.begin(), order.end(), 0));
+        order.insert(order.begin(), 0);
+    }
+    if (std::is_sorted(order.begin(), order.end())) {
+        return false;
+    }
+
+    // We permute the axes of each instruction by swapping one pair of axes at a time
+    vector<InstrPtr> new_instr_list;
+    for (const InstrPtr &instr: instr_list) {
+        bh_instruction tmp(*instr);
+        vector<int> current(order.size()); // The original axis that is currently at each position
+        for (int axis = 0; axis < ndim; ++axis) {
+            current[axis] = axis;
+        }
+        for (int pos = 0; pos < ndim; ++pos) {
+            const int from = static_cast<int>(std::find(current.begin(), current.end(), order[pos]) - current.begin());
+            if (from != pos) {
+                tmp.transpose(pos, from);
+                std::swap(current[pos], current[from]);
+            }
+        }
+        new_instr_list.push_back(std::make_shared<bh_instruction>(tmp));
+    }
+    Block interchanged = create_nested_block(new_instr_list, loop.rank, loop.getAllFrees());
+    loop = std::move(interchanged.getLoop());
+    return true;
+}
+
 // Help function that collapses 'loop' with its child if possible
 bool collapse_loop_with_child(LoopB &loop) {
     // In order to be collapsable, 'loop' can only have one child, that child must be a loop, and both 'loop'
@@ -244,6 +594,35 @@ void collapse_redundant_axes(vector<Block> &block_list) {
     }
     block_list = ret;
 }
+void interchange_loops(vector<Block> &block_list, uint64_t min_threading) {
+    for (Block &block: block_list) {
+        if (not block.isInstr()) {
+            interchange_loop(block.getLoop(), min_threading);
+        }
+    }
+}
+
+void tile_for_cache(vector<Block> &block_list, uint64_t cache_size, uint64_t l2_size) {
+    if (cache_size == 0) {
+        cache_size = l1_cache_size();
+    }
+    if (l2_size == 0) {
+        l2_size = l2_cache_size();
+    }
+    vector<Block> ret;
+    for (const Block &block: block_list) {
+        vector<Block> tiled;
+        if (not block.isInstr()) {
+            tiled = tile_loop(block.getLoop(), cache_size, l2_size);
+        }
+        if (tiled.empty()) {
+            ret.push_back(block);
+        } else {
+            ret.insert(ret.end(), tiled.begin(), tiled.end());
+        }
+    }
+    block_list = ret;
+}
+
 } // jitk
 } // bohrium
-
@@ -19,6 +19,7 @@ If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <sstream>
+#include <algorithm>
 
 #include <bohrium/jitk/scope.hpp>
 
@@ -28,63 +29,107 @@ using namespace std;
 namespace bohrium {
 namespace jitk {
 
-void write_array_index(const Scope &scope, const bh_view &view, stringstream &out, bool ignore_declared_indexes,
-                       int hidden_axis, const pair<int, int> axis_offset) {
+namespace {
+// Write the first index of the loop of rank 'rank', which is per thread when the loop is a parallel prefix scan
+void write_first_index(const Scope &scope, int rank, stringstream &out) {
+    if (scope.isParallelScan(rank)) {
+        out << "i" << rank << "_first";
+    } else {
+        out << "0";
+    }
+}
 
-    // Let's check if the index is already declared as a variable
-    if (not ignore_declared_indexes) {
-        if (scope.isIdxDeclared(view)) {
-            scope.getIdxName(view, out);
-            return;
+// Write the terms of the axes `first_axis` to `last_axis` (both inclusive) of 'view', e.g. " +i1*10 +i2"
+void write_index_terms(const Scope &scope, const bh_view &view, int first_axis, int last_axis, int hidden_axis,
+                       const pair<int, int> axis_offset, stringstream &out, bool &empty_subscription) {
+    const bool strides_as_var = scope.symbols.strides_as_var and scope.symbols.existOffsetStridesID(view);
+    for (int i = first_axis; i <= last_axis; ++i) {
+        int t = i;
+        if (i >= hidden_axis) {
+            ++t;
+        }
+        if (strides_as_var or view.stride[i] != 0) {
+            if (axis_offset.first == t) {
+                out << " +(i" << t << "+(i" << t << "==";
+                write_first_index(scope, t, out);
+                out << "?0:" << axis_offset.second << ")) ";
+            } else {
+                out << " +i" << t;
+            }
+            if (strides_as_var) {
+                out << "*vs" << scope.symbols.offsetStridesID(view) << "_" << i;
+            } else if (view.stride[i] != 1) {
+                out << "*" << view.stride[i];
+            }
+            empty_subscription = false;
         }
     }
+}
 
-    if (scope.symbols.strides_as_var and scope.symbols.existOffsetStridesID(view)) {
-        // Write view.start using the offset-and-strides variable
-        out << "vo" << scope.symbols.offsetStridesID(view);
-
-        if (not view.is_scalar()) { // NB: this optimization is required when reducing a vector to a scalar!
-            for (int i = 0; i < view.ndim; ++i) {
-                int t = i;
-                if (i >= hidden_axis) {
-                    ++t;
-                }
-                if (axis_offset.first == t) {
-                    out << " +(i" << t << "+(i" << t << "==0?0:" << axis_offset.second << ")) ";
-                } else {
-                    out << " +i" << t;
-                }
-                out << "*vs" << scope.symbols.offsetStridesID(view) << "_" << i;
+// Write the index of 'view' that covers the axes up to `last_axis` (inclusive). The index starts at the deepest
+// partial index declared in 'scope' (see `Scope::writePartialIdxDeclaration()`) that doesn't cover 'hidden_axis'
+// or the offset axis of 'axis_offset'.
+void write_partial_index(const Scope &scope, const bh_view &view, int last_axis, int hidden_axis,
+                         const pair<int, int> axis_offset, stringstream &out) {
+    bool empty_subscription = true;
+    int first_axis = 0;
+    if (scope.symbols.index_strength_reduce) {
+        const int last_partial = std::min({last_axis, hidden_axis, axis_offset.first}) - 1;
+        for (int rank = last_partial; rank >= 0; --rank) {
+            if (scope.isPartialIdxDeclared(view, rank)) {
+                scope.getPartialIdxName(view, rank, out);
+                first_axis = rank + 1;
+                empty_subscription = false;
+                break;
             }
         }
-    } else {
-        bool empty_subscription = true;
-        if (view.start > 0) {
+    }
+    if (first_axis == 0) {
+        if (scope.symbols.strides_as_var and scope.symbols.existOffsetStridesID(view)) {
+            // Write view.start using the offset-and-strides variable
+            out << "vo" << scope.symbols.offsetStridesID(view);
+            empty_subscription = false;
+        } else if (view.start > 0) {
             out << view.start;
             empty_subscription = false;
         }
-        if (not view.is_scalar()) { // NB: this optimization is required when reducing a vector to a scalar!
-            for (int i = 0; i < view.ndim; ++i) {
-                int t = i;
-                if (i >= hidden_axis)
-                    ++t;
-                if (view.stride[i] != 0) {
-                    if (axis_offset.first == t) {
-                        out << " +(i" << t << "+(i" << t << "==0?0:" << axis_offset.second << ")) ";
-                    } else {
-                        out << " +i" << t;
-                    }
-                    if (view.stride[i] != 1) {
-                        out << "*" << view.stride[i];
-                    }
-                    empty_subscription = false;
-                }
-            }
-        }
-        if (empty_subscription) {
-            out << "0";
+    }
+    if (not view.is_scalar()) { // NB: this optimization is required when reducing a vector to a scalar!
+        write_index_terms(scope, view, first_axis, last_axis, hidden_axis, axis_offset, out, empty_subscription);
+    }
+    if (empty_subscription) {
+        out << "0";
+    }
+}
+}
+
+bh_view range_index_view(const bh_view &view) {
+    bh_view ret(view);
+    ret.start = 0;
+    ret.slides = nullptr;
+    int64_t stride = 1;
+    for (int64_t i = ret.ndim - 1; i >= 0; --i) {
+        ret.stride[i] = stride;
+        stride *= ret.shape[i];
+    }
+    return ret;
+}
+
+void write_array_index(const Scope &scope, const bh_view &view, stringstream &out, bool ignore_declared_indexes,
+                       int hidden_axis, const pair<int, int> axis_offset) {
+
+    // Let's check if the index is already declared as a variable
+    if (not ignore_declared_indexes) {
+        if (scope.isIdxDeclared(view)) {
+            scope.getIdxName(view, out);
+            return;
         }
     }
+    write_partial_index(scope, view, static_cast<int>(view.ndim) - 1, hidden_axis, axis_offset, out);
+}
+
+void write_array_partial_index(const Scope &scope, const bh_view &view, int rank, stringstream &out) {
+    write_partial_index(scope, view, rank, BH_MAXDIM, make_pair(BH_MAXDIM, 0), out);
 }
 
 void write_array_subscription(const Scope &scope, const bh_view &view, stringstream &out, bool ignore_declared_indexes,
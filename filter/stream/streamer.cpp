@@ -0,0 +1,298 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <map>
+#include <set>
+#include <algorithm>
+#include "streamer.hpp"
+
+using namespace std;
+
+namespace bohrium {
+namespace filter {
+namespace stream {
+    bool __verbose = false;
+
+namespace {
+// Return the element-wise opcode that combines two partial results of the reduction `reduce`
+bh_opcode combine_opcode(bh_opcode reduce) {
+    switch (reduce) {
+        case BH_ADD_REDUCE:
+            return BH_ADD;
+        case BH_MULTIPLY_REDUCE:
+            return BH_MULTIPLY;
+        case BH_MINIMUM_REDUCE:
+            return BH_MINIMUM;
+        case BH_MAXIMUM_REDUCE:
+            return BH_MAXIMUM;
+        case BH_LOGICAL_AND_REDUCE:
+            return BH_LOGICAL_AND;
+        case BH_LOGICAL_OR_REDUCE:
+            return BH_LOGICAL_OR;
+        case BH_LOGICAL_XOR_REDUCE:
+            return BH_LOGICAL_XOR;
+        case BH_BITWISE_AND_REDUCE:
+            return BH_BITWISE_AND;
+        case BH_BITWISE_OR_REDUCE:
+            return BH_BITWISE_OR;
+        case BH_BITWISE_XOR_REDUCE:
+            return BH_BITWISE_XOR;
+        default:
+            return BH_NONE;
+    }
+}
+
+// Is `instr` a reduction along the outermost axis, which is computed per chunk and combined?
+bool is_outer_reduction(const bh_instruction &instr) {
+    return bh_opcode_is_reduction(instr.opcode) and instr.sweep_axis() == 0;
+}
+
+// Find the memory rows of `view` where row `i` of the view lies within memory row `first_row + i` of size
+// `row_stride`. Returns false when the rows of the view overlap or have a non-positive stride.
+bool view_rows(const bh_view &view, int64_t &first_row, int64_t &row_stride) {
+    row_stride = view.stride[0];
+    if (row_stride <= 0) {
+        return false;
+    }
+    int64_t extent = 1;
+    for (int64_t i = 1; i < view.ndim; ++i) {
+        if (view.stride[i] < 0) {
+            return false;
+        }
+        extent += view.stride[i] * (view.shape[i] - 1);
+    }
+    first_row = view.start / row_stride;
+    return view.start % row_stride + extent <= row_stride;
+}
+
+// Return `view` with only the rows from `begin` to `end`
+bh_view slice_rows(bh_view view, int64_t begin, int64_t end) {
+    view.start += begin * view.stride[0];
+    view.shape[0] = end - begin;
+    return view;
+}
+
+// Return the number of bytes of a row of `view`
+uint64_t row_bytes(const bh_view &view) {
+    int64_t nelem = 1;
+    for (int64_t i = 1; i < view.ndim; ++i) {
+        nelem *= view.shape[i];
+    }
+    return static_cast<uint64_t>(nelem * bh_type_size(view.base->dtype()));
+}
+}
+
+Streamer::Streamer(bool verbose, uint64_t chunk_bytes) : chunk_bytes_(chunk_bytes) {
+    __verbose = verbose;
+}
+
+vector<BhIR> Streamer::split(const BhIR &bhir) {
+    if (bhir.getNRepeats() != 1 or bhir._repeat_condition != nullptr) {
+        return {};
+    }
+
+    // Check the instructions and find the number of rows, the arrays written, and the first access of each array
+    int64_t nrows = -1;
+    map<bh_base *, int> num_writes;
+    set<bh_base *> partial_outputs;
+    set<bh_base *> frees;
+    map<bh_base *, pair<const bh_instruction *, size_t> > first_access; // Maps an array to an instruction and operand
+    for (const bh_instruction &instr: bhir.instr_list) {
+        if (bh_opcode_is_system(instr.opcode)) {
+            if (instr.opcode == BH_FREE) {
+                frees.insert(instr.operand[0].base);
+            }
+            continue;
+        }
+        if (not (bh_opcode_is_elementwise(instr.opcode) or bh_opcode_is_reduction(instr.opcode) or
+                 bh_opcode_is_accumulate(instr.opcode))) {
+            verbose_print("Cannot stream " + string(bh_opcode_text(instr.opcode)));
+            return {};
+        }
+        const BhIntVec shape = instr.shape();
+        if (shape.empty() or (nrows != -1 and shape[0] != nrows)) {
+            return {};
+        }
+        nrows = shape[0];
+        if (is_outer_reduction(instr)) {
+            if (combine_opcode(instr.opcode) == BH_NONE) {
+                return {};
+            }
+            partial_outputs.insert(instr.operand[0].base);
+        } else if (bh_opcode_is_accumulate(instr.opcode) and instr.sweep_axis() == 0) {
+            return {};
+        }
+        for (size_t i = 0; i < instr.operand.size(); ++i) {
+            const bh_view &view = instr.operand[i];
+            if (view.isConstant()) {
+                continue;
+            }
+            if (view.hasSlide()) {
+                return {};
+            }
+            if (not (i == 0 and is_outer_reduction(instr)) and (view.ndim < 1 or view.shape[0] != nrows)) {
+                return {};
+            }
+        }
+        // NB: the inputs are accessed before the output
+        for (size_t i = instr.operand.size(); i-- > 0;) {
+            if (not instr.operand[i].isConstant()) {
+                first_access.insert(make_pair(instr.operand[i].base, make_pair(&instr, i)));
+            }
+        }
+        ++num_writes[instr.operand[0].base];
+    }
+    if (nrows < 2) {
+        return {};
+    }
+
+    // The output of a reduction along the outermost axis is a partial result until the last chunk thus only the
+    // reduction may access it. All other arrays that are written must be accessed in the same rows by all views.
+    map<bh_base *, pair<int64_t, int64_t> > rows;
+    map<bh_base *, uint64_t> array_row_bytes;
+    for (const bh_instruction &instr: bhir.instr_list) {
+        if (bh_opcode_is_system(instr.opcode)) {
+            continue;
+        }
+        for (size_t i = 0; i < instr.operand.size(); ++i) {
+            const bh_view &view = instr.operand[i];
+            if (view.isConstant()) {
+                continue;
+            }
+            if (util::exist(partial_outputs, view.base)) {
+                if (not (i == 0 and is_outer_reduction(instr)) or num_writes.at(view.base) != 1) {
+                    return {};
+                }
+                continue;
+            }
+            if (util::exist(num_writes, view.base)) {
+                pair<int64_t, int64_t> r;
+                if (not view_rows(view, r.first, r.second)) {
+                    return {};
+                }
+                auto it = rows.insert(make_pair(view.base, r)).first;
+                if (it->second != r) {
+                    return {};
+                }
+            }
+            uint64_t &nbytes = array_row_bytes[view.base];
+            nbytes = max(nbytes, row_bytes(view));
+        }
+    }
+
+    // Arrays created and freed within the BhIR are freed after each chunk, which makes it possible for the
+    // child to contract them. An array is created when its first access writes the whole array.
+    set<bh_base *> temps;
+    for (bh_base *base: frees) {
+        auto it = first_access.find(base);
+        if (it == first_access.end() or it->second.second != 0 or util::exist(partial_outputs, base) or
+            util::exist(bhir._syncs, base)) {
+            continue;
+        }
+        const bh_view &view = it->second.first->operand[0];
+        if (view.start == 0 and view.isContiguous() and view.shape.prod() == base->nelem()) {
+            temps.insert(base);
+        }
+    }
+
+    // Find the number of rows of a chunk
+    uint64_t nbytes_per_row = 0;
+    for (const auto &array: array_row_bytes) {
+        nbytes_per_row += array.second;
+    }
+    const int64_t rows_per_chunk = max(static_cast<int64_t>(chunk_bytes_ / max(nbytes_per_row, uint64_t{1})),
+                                       int64_t{1});
+    if (rows_per_chunk >= nrows) {
+        return {};
+    }
+    const int64_t nchunks = (nrows + rows_per_chunk - 1) / rows_per_chunk;
+    verbose_print("Splitting " + to_string(nrows) + " rows into " + to_string(nchunks) + " chunks of " +
+                  to_string(rows_per_chunk) + " rows (" + to_string(temps.size()) + " arrays are freed per chunk)");
+
+    // The partial result of each reduction along the outermost axis
+    map<const bh_instruction *, bh_view> partials;
+    for (const bh_instruction &instr: bhir.instr_list) {
+        if (not bh_opcode_is_system(instr.opcode) and is_outer_reduction(instr)) {
+            const bh_view &out = instr.operand[0];
+            partials_.emplace_back(new bh_base(out.shape.prod(), out.base->dtype()));
+            BhIntVec stride(out.ndim);
+            int64_t weight = 1;
+            for (int64_t i = out.ndim - 1; i >= 0; --i) {
+                stride[i] = weight;
+                weight *= out.shape[i];
+            }
+            partials[&instr] = bh_view(partials_.back().get(), 0, out.ndim, out.shape, stride);
+        }
+    }
+
+    vector<BhIR> ret;
+    ret.reserve(static_cast<size_t>(nchunks));
+    for (int64_t chunk = 0; chunk < nchunks; ++chunk) {
+        const int64_t begin = chunk * rows_per_chunk;
+        const int64_t end = min(begin + rows_per_chunk, nrows);
+        const bool last = chunk == nchunks - 1;
+        vector<bh_instruction> instr_list;
+        for (const bh_instruction &instr: bhir.instr_list) {
+            if (bh_opcode_is_system(instr.opcode)) {
+                // Frees and the like are only executed after the last chunk
+                if (last and instr.opcode != BH_NONE) {
+                    instr_list.push_back(instr);
+                }
+                continue;
+            }
+            bh_instruction sliced(instr);
+            for (size_t i = 0; i < sliced.operand.size(); ++i) {
+                if (not sliced.operand[i].isConstant() and not (i == 0 and is_outer_reduction(instr))) {
+                    sliced.operand[i] = slice_rows(sliced.operand[i], begin, end);
+                }
+            }
+            if (is_outer_reduction(instr) and chunk > 0) {
+                // Reduce the chunk into the partial result and combine it with the output
+                const bh_view &out = instr.operand[0];
+                const bh_view &partial = partials.at(&instr);
+                sliced.operand[0] = partial;
+                instr_list.push_back(sliced);
+                instr_list.emplace_back(combine_opcode(instr.opcode), BhOperandVec{out, out, partial});
+                instr_list.emplace_back(BH_FREE, BhOperandVec{partial});
+            } else {
+                instr_list.push_back(std::move(sliced));
+            }
+        }
+        if (not last) {
+            for (bh_base *base: temps) {
+                instr_list.emplace_back(BH_FREE, BhOperandVec{bh_view(base)});
+            }
+        }
+        ret.emplace_back(std::move(instr_list), last ? bhir._syncs : set<bh_base *>());
+    }
+    return ret;
+}
+
+void Streamer::cleanup() {
+    partials_.clear();
+}
+
+void verbose_print(std::string str)
+{
+    if (__verbose) {
+        std::cout << "[Streamer] " << str << std::endl;
+    }
+}
+
+}}}
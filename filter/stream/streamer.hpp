@@ -0,0 +1,68 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <bohrium/bh_component.hpp>
+
+namespace bohrium {
+namespace filter {
+namespace stream {
+
+extern bool __verbose;
+extern void verbose_print(std::string str);
+
+/** Splits a BhIR along the outermost axis into chunks of rows where each chunk runs the whole instruction list.
+ *  A BhIR is streamable when all instructions are element-wise, reductions, or accumulations (not along the
+ *  outermost axis) over the same number of rows and every array written in the BhIR is accessed row by row
+ *  in the same memory rows by all its views. Reductions along the outermost axis are computed per chunk and
+ *  combined into the output, which must not be accessed by any other instruction.
+ *  Arrays that are both created and freed within the BhIR are freed after each chunk.
+ */
+class Streamer
+{
+public:
+    /**
+     *  Construct the streamer.
+     *
+     * @param verbose     Print the chunking of each BhIR
+     * @param chunk_bytes The number of bytes of the rows of a chunk
+     */
+    Streamer(bool verbose, uint64_t chunk_bytes);
+
+    /**
+     *  Split `bhir` into chunks, which must be executed in order. Returns an empty list when `bhir`
+     *  isn't streamable or fits in one chunk.
+     */
+    std::vector<BhIR> split(const BhIR &bhir);
+
+    /**
+     *  Delete the arrays of the partial reduction results, which must be called after the chunks of
+     *  the last split has been executed.
+     */
+    void cleanup();
+
+private:
+    uint64_t chunk_bytes_;
+    std::vector<std::unique_ptr<bh_base> > partials_;
+};
+
+}}}
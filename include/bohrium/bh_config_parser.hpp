@@ -283,6 +283,14 @@ public:
         return defaultGetList(_default_section, option, default_value);
     }
 
+    /** Return all options within the default section as a string of `option=value;` pairs.
+     * Like `get()`, environment variables overwrite the values of the ini file.
+     * Use this to recognize data that depends on the configuration such as persistent caches.
+     *
+     * @return The options as a string
+     */
+    std::string getSectionAsString() const;
+
     /** Return the path to the library that implements the calling component's child or "" if the child doesn't exist.
      *
      * @return File path to shared library or the empty string
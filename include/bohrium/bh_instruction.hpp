@@ -19,9 +19,12 @@ If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <boost/archive/archive_exception.hpp>
 #include <boost/serialization/is_bitwise_serializable.hpp>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/container/static_vector.hpp>
 #include <boost/range/adaptor/filtered.hpp>
 #include <vector>
 #include <set>
@@ -32,12 +35,16 @@ If not, see <http://www.gnu.org/licenses/>.
 // Forward declaration of class boost::serialization::access
 namespace boost { namespace serialization { class access; }}
 
+/// The operands of an instruction, which are stored inline thus recording and copying instructions never allocates.
+/// NB: unlike `BhStaticVector`, copying only copies the operands in use, which matters since a view is large
+typedef boost::container::static_vector<bh_view, BH_MAX_NO_OPERANDS> BhOperandVec;
+
 /// Memory layout of the Bohrium instruction
 struct bh_instruction {
     // Opcode: Identifies the operation
     bh_opcode opcode = -1;
     // Id of each operand
-    std::vector<bh_view> operand;
+    BhOperandVec operand;
     // Constant included in the instruction (Used if one of the operands == NULL)
     bh_constant constant{};
     // Flag that indicates whether this instruction construct the output array (i.e. is the first operation on that array)
@@ -51,26 +58,18 @@ struct bh_instruction {
     /// Constructors
     bh_instruction() = default;
 
-    bh_instruction(bh_opcode opcode, std::vector<bh_view> operands) : opcode(opcode), operand(std::move(operands)) {}
-
-    bh_instruction(const bh_instruction &instr) {
-        opcode = instr.opcode;
-        constant = instr.constant;
-        constructor = instr.constructor;
-        origin_id = instr.origin_id;
-        operand = instr.operand;
-    }
+    bh_instruction(bh_opcode opcode, BhOperandVec operands) : opcode(opcode), operand(std::move(operands)) {}
 
     /// Return a set of all bases used by the instruction
     std::set<bh_base *> get_bases();
 
     /// Return an range over all views excluding constants
-    boost::filtered_range<bh_view::predicate_isNotConstant, std::vector<bh_view> > getViews() {
+    boost::filtered_range<bh_view::predicate_isNotConstant, BhOperandVec> getViews() {
         return boost::adaptors::filter(operand, bh_view::predicate_isNotConstant());
     }
 
     /// Return an range over all views excluding constants (const version)
-    boost::filtered_range<bh_view::predicate_isNotConstant, const std::vector<bh_view> > getViews() const {
+    boost::filtered_range<bh_view::predicate_isNotConstant, const BhOperandVec> getViews() const {
         return boost::adaptors::filter(operand, bh_view::predicate_isNotConstant());
     }
 
@@ -152,12 +151,29 @@ struct bh_instruction {
     friend class boost::serialization::access;
 
     template<class Archive>
-    void serialize(Archive &ar, const unsigned int version) {
-        ar & opcode;
-        ar & operand;
+    void save(Archive &ar, const unsigned int version) const {
+        ar << opcode;
+        const uint64_t noperands = operand.size();
+        ar << noperands;
+        ar << boost::serialization::make_array(operand.data(), operand.size());
         //We use make_array as a hack to make bh_constant BOOST_IS_BITWISE_SERIALIZABLE
-        ar & boost::serialization::make_array(&constant, 1);
+        ar << boost::serialization::make_array(&constant, 1);
+    }
+
+    template<class Archive>
+    void load(Archive &ar, const unsigned int version) {
+        ar >> opcode;
+        uint64_t noperands;
+        ar >> noperands;
+        if (noperands > BH_MAX_NO_OPERANDS) {
+            throw boost::archive::archive_exception(boost::archive::archive_exception::input_stream_error);
+        }
+        operand.resize(static_cast<size_t>(noperands));
+        ar >> boost::serialization::make_array(operand.data(), operand.size());
+        ar >> boost::serialization::make_array(&constant, 1);
     }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 };
 BOOST_IS_BITWISE_SERIALIZABLE(bh_constant)
 
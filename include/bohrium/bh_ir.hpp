@@ -22,6 +22,7 @@ If not, see <http://www.gnu.org/licenses/>.
 #include <vector>
 #include <map>
 #include <set>
+#include <memory>
 
 #include <bohrium/bh_instruction.hpp>
 
@@ -39,6 +40,8 @@ public:
     // Repeat while this base evaluate to True or is a nullptr.
     // NB: the `base->getDataPtr()` must point to a single element of type BH_BOOL
     bh_base *_repeat_condition;
+    // The slides of the views in `instr_list` (see `bh_view::slides`)
+    std::vector<std::shared_ptr<bh_slide> > _slides;
 
 public:
     /** The regular constructor that takes the instructions, the sync'ed arrays, and number of times to run the BhIR */
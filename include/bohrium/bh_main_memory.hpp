@@ -20,8 +20,111 @@ If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <cstddef>
+#include <string>
+#include <map>
+#include <vector>
+#include <functional>
 #include <bohrium/bh_base.hpp>
 
+/** The NUMA placement of large main memory allocations
+ *  NONE:        the kernel places each page on the node of the thread that touches it first
+ *  INTERLEAVE:  the pages are interleaved across all nodes
+ *  FIRST_TOUCH: the pages are touched by a parallel first-touch function when allocated, which should
+ *               distribute them like the kernels that use the memory
+ *  LOCAL:       the pages are placed on the node of the allocating thread
+ */
+enum class NumaPolicy { NONE, INTERLEAVE, FIRST_TOUCH, LOCAL };
+
+/** Return the NUMA policy named `name` ('none', 'interleave', 'first_touch', or 'local') */
+NumaPolicy bh_numa_policy_from_string(const std::string &name);
+
+/** Return the number of NUMA nodes on this machine (one when not available) */
+int bh_numa_num_nodes();
+
+/** Set the NUMA policy of main memory allocations of at least `threshold` bytes.
+ *  Cached allocations are only reused by allocations of the same placement (the node with the LOCAL policy).
+ *
+ * @param policy       The NUMA policy
+ * @param threshold    Allocations smaller than `threshold` bytes ignore `policy`
+ * @param first_touch  The function that touches new allocations with the FIRST_TOUCH policy
+ */
+void bh_set_numa_policy(NumaPolicy policy, uint64_t threshold,
+                        std::function<void(void *, uint64_t)> first_touch = nullptr);
+
+/** The page size of large main memory allocations
+ *  NONE:    the kernel decides (e.g. transparent huge pages if enabled system-wide)
+ *  THP:     the allocations are advised to use transparent huge pages (`madvise(MADV_HUGEPAGE)`)
+ *  HUGETLB: the allocations are taken from the pool of reserved huge pages (`MAP_HUGETLB`) and fall back to
+ *           transparent huge pages when the pool is exhausted
+ */
+enum class PagePolicy { NONE, THP, HUGETLB };
+
+/** Return the page policy named `name` ('none', 'thp', or 'hugetlb') */
+PagePolicy bh_page_policy_from_string(const std::string &name);
+
+/** The prefaulting of large main memory allocations, which moves the page faults out of the kernels
+ *  NONE:     the pages are faulted in by the kernels that touch them first
+ *  POPULATE: the pages are faulted in by the allocating thread (`MAP_POPULATE` or equivalent)
+ *  PARALLEL: the pages are faulted in by the parallel touch function
+ */
+enum class PrefaultPolicy { NONE, POPULATE, PARALLEL };
+
+/** Return the prefault policy named `name` ('none', 'populate', or 'parallel') */
+PrefaultPolicy bh_prefault_policy_from_string(const std::string &name);
+
+/** Set the page and prefault policies of main memory allocations.
+ *  Cached allocations are only reused by allocations of the same page policy.
+ *  NB: allocations with the FIRST_TOUCH NUMA policy are never prefaulted since they are touched anyway
+ *
+ * @param page_policy        The page policy
+ * @param page_threshold     Allocations smaller than `page_threshold` bytes ignore `page_policy`
+ * @param prefault           The prefault policy
+ * @param prefault_threshold Allocations smaller than `prefault_threshold` bytes ignore `prefault`
+ * @param parallel_touch     The function that touches new allocations with the PARALLEL prefault policy
+ */
+void bh_set_page_policy(PagePolicy page_policy, uint64_t page_threshold, PrefaultPolicy prefault,
+                        uint64_t prefault_threshold, std::function<void(void *, uint64_t)> parallel_touch = nullptr);
+
+/** Retrieve the page faults and data TLB misses of this process since the first call
+ *
+ * @param minor_faults Page faults serviced without I/O
+ * @param major_faults Page faults that required I/O
+ * @param dtlb_misses  Data TLB load misses or -1 when the performance counter isn't available
+ */
+void bh_get_page_fault_stat(uint64_t &minor_faults, uint64_t &major_faults, int64_t &dtlb_misses);
+
+/** Set the budget of main memory arrays. When the arrays allocated through `bh_data_malloc()` exceed the budget,
+ *  arrays are spilled to files in `dir` where they stay accessible through file-backed mappings until
+ *  `bh_spill_prepare()` faults them back in. The size limit of the malloc cache is capped by the budget.
+ *
+ * @param budget The budget in bytes or zero to disable spilling
+ * @param dir    The directory of the spill files (the files are unlinked when created)
+ */
+void bh_set_spill_budget(uint64_t budget, const std::string &dir);
+
+/** Return true when spilling is enabled (see `bh_set_spill_budget()`) */
+bool bh_spill_enabled();
+
+/** Prepare a kernel that uses the arrays `bases`, which are faulted back in if spilled. Until the next call,
+ *  `bases` are never spilled and the arrays are spilled in the order of their next use where the array
+ *  used last is spilled first. Arrays never passed to this function (e.g. the arena of a memory plan) are
+ *  never spilled.
+ *  NB: call it with an empty list and no `next_use` after the last kernel since `next_use` might dangle
+ *
+ * @param bases    The arrays of the kernel
+ * @param next_use Returns the index of the next pending kernel that uses an array, which must be larger for
+ *                 arrays used later. When nullptr, the least recently used arrays are spilled first.
+ */
+void bh_spill_prepare(const std::vector<bh_base *> &bases,
+                      std::function<uint64_t(const bh_base *)> next_use = nullptr);
+
+/** Retrieve the number of bytes spilled to disk and faulted back in
+ *
+ * @param spilled_bytes  Bytes written to spill files
+ * @param restored_bytes Bytes read back from spill files
+ */
+void bh_get_spill_stat(uint64_t &spilled_bytes, uint64_t &restored_bytes);
+
 /** Return the size of the physical memory on this machine */
 uint64_t bh_main_memory_total();
 
@@ -50,6 +153,12 @@ void bh_data_free(bh_base* base);
  */
 void bh_set_malloc_cache_limit(uint64_t nbytes);
 
+/** Set the size tolerance of the main memory malloc cache (see MallocCache::setTolerance())
+ *
+ * @param tolerance The tolerance as a fraction of the requested size
+ */
+void bh_set_malloc_cache_tolerance(double tolerance);
+
 /** Retrieve statistic from the main memory malloc cache
  *
  * @param cache_lookup Cache lookups
@@ -57,3 +166,11 @@ void bh_set_malloc_cache_limit(uint64_t nbytes);
  * @param max_memory_usage Total memory usage, which includes ALL memory allocated through the memory cache
  */
 void bh_get_malloc_cache_stat(uint64_t &cache_lookup, uint64_t &cache_misses, uint64_t &max_memory_usage);
+
+/** Retrieve the maximum memory usage of each NUMA placement (e.g. 'interleave' or 'node1') from the main memory
+ *  malloc cache. Allocations below the threshold of the NUMA policy are named 'default' and allocations with
+ *  a page policy are suffixed with it (e.g. 'node1 (thp)').
+ *
+ * @param max_memory_usage Maps the placement to its maximum memory usage
+ */
+void bh_get_malloc_cache_numa_stat(std::map<std::string, uint64_t> &max_memory_usage);
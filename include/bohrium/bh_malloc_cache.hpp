@@ -19,7 +19,16 @@ If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
-#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <deque>
+#include <set>
+#include <map>
+#include <utility>
+#include <unordered_map>
+#include <functional>
+#include <cassert>
 #include <sstream>
 #include <stdexcept>
 #include <bohrium/bh_util.hpp>
@@ -29,69 +38,117 @@ namespace bohrium {
 /** Cache of memory allocations. Instead of freeing a memory allocation immediately, this cache
  * retain the allocation for later reuse.
  * To use, simply allocate and free all memory allocations through the method `alloc()` and `free()`
+ *
+ * The cached segments are binned by size, which makes an exact-size lookup O(1). When no segment of the exact
+ * size exist, the smallest segment within the size tolerance (see setTolerance()) is reused instead and if the
+ * split granularity is non-zero, a larger segment is split into a used part and a part that stays in the cache.
+ * Eviction is in least-recently-used order.
+ *
+ * An allocation can have a tag (e.g. the NUMA node of main memory) in which case only cached segments with
+ * the same tag are reused. The memory allocated is accounted per tag.
  */
 class MallocCache {
 public:
     typedef std::function<void *(uint64_t)> FuncAllocT;
+    typedef std::function<void *(uint64_t, int)> FuncTaggedAllocT;
     typedef std::function<void(void *, uint64_t)> FuncFreeT;
+    typedef std::function<void(void *, uint64_t, int)> FuncTaggedFreeT;
 
 private:
-    // A segment consist of a memory allocation and a size
+    // A segment consist of a memory allocation, a size, and a tag
     struct Segment {
         std::uint64_t nbytes;
         void *mem;
+        int tag;
     };
-    std::vector<Segment> _segments; // Segments in the cache
+    typedef std::list<Segment>::iterator SegmentIter;
+
+    // A bin is identified by the tag and the size of its segments
+    typedef std::pair<int, uint64_t> BinKey;
+    struct BinKeyHash {
+        size_t operator()(const BinKey &key) const {
+            return std::hash<uint64_t>()(key.second) ^ (std::hash<int>()(key.first) << 1);
+        }
+    };
+
+    // Segments in the cache ordered by the time they were freed (least recently used first)
+    std::list<Segment> _segments;
+
+    // Size-class bins that map a tag and a segment size to the segments of that tag and size.
+    // NB: the segments within a bin appear in the same order as in `_segments`
+    std::unordered_map<BinKey, std::deque<SegmentIter>, BinKeyHash> _bins;
+
+    // The keys of all non-empty bins, which we use for best-fit lookups
+    std::set<BinKey> _bin_sizes;
+
+    // Memory allocations handed out that are larger than requested (maps the allocation to its actual size)
+    std::unordered_map<void *, uint64_t> _oversized;
+
+    // Memory allocations handed out that have a non-zero tag (maps the allocation to its tag)
+    std::unordered_map<void *, int> _tags;
 
     // Pointers to malloc and free functions
-    FuncAllocT _func_alloc;
-    FuncFreeT _func_free;
+    FuncTaggedAllocT _func_alloc;
+    FuncTaggedFreeT _func_free;
 
     uint64_t _cache_size = 0; // Current size of the cache (in bytes)
     uint64_t _mem_allocated = 0; // Current memory allocated inside and outside the cache (in bytes)
     uint64_t _mem_allocated_limit; // The limit of `_mem_allocated`
 
+    // A cached segment up to `_tolerance` times larger than the requested size might be reused
+    double _tolerance;
+    // The maximum number of bins beyond the size tolerance that `_find()` scans for a splittable segment
+    static constexpr int MAX_SPLIT_SCAN = 16;
+    // The granularity in bytes in which a cached segment might be split (zero disables splitting)
+    uint64_t _split_granularity;
+
     // Some statistics
     uint64_t _stat_lookups = 0;
     uint64_t _stat_misses = 0;
     uint64_t _stat_allocated_max = 0;
+    std::map<int, uint64_t> _mem_allocated_per_tag;
+    std::map<int, uint64_t> _stat_allocated_max_per_tag;
 
     /** Allocate memory of size `nbytes`
      *
      * @param nbytes Number of bytes to allocate
+     * @param tag The tag of the allocation
      * @return Pointer to the allocation
      */
-    void *_malloc(uint64_t nbytes) {
-        void *ret = _func_alloc(nbytes);
+    void *_malloc(uint64_t nbytes, int tag) {
+        void *ret = _func_alloc(nbytes, tag);
         _mem_allocated += nbytes;
         if (_mem_allocated > _stat_allocated_max) {
             _stat_allocated_max = _mem_allocated;
         }
+        uint64_t &tag_allocated = _mem_allocated_per_tag[tag];
+        tag_allocated += nbytes;
+        uint64_t &tag_max = _stat_allocated_max_per_tag[tag];
+        if (tag_allocated > tag_max) {
+            tag_max = tag_allocated;
+        }
         return ret;
     }
 
-    /** Free the memory allocation `mem` of size `nbytes` */
-    void _free(void *mem, uint64_t nbytes) {
+    /** Free the memory allocation `mem` of size `nbytes` and tag `tag` */
+    void _free(void *mem, uint64_t nbytes, int tag) {
         assert(mem != nullptr);
-        _func_free(mem, nbytes);
+        _func_free(mem, nbytes, tag);
         assert(_mem_allocated >= nbytes);
         _mem_allocated -= nbytes;
+        assert(_mem_allocated_per_tag[tag] >= nbytes);
+        _mem_allocated_per_tag[tag] -= nbytes;
     }
 
-    /** Evict a range of memory allocations from the cache
-     *
-     * @param first Iterator pointing to the first allocation
-     * @param last Iterator pointing to the element just after the last allocation
-     * @param call_free When true, the memory allocations are also freed
-     */
-    void _evict(std::vector<Segment>::iterator first, std::vector<Segment>::iterator last, bool call_free) {
-        for (auto it = first; it != last; ++it) {
-            if (call_free) {
-                _free(it->mem, it->nbytes);
-            }
-            _cache_size -= it->nbytes;
+    /** Insert a segment as the most recently used segment in the cache */
+    void _insert(uint64_t nbytes, void *mem, int tag) {
+        _segments.push_back(Segment{nbytes, mem, tag});
+        std::deque<SegmentIter> &bin = _bins[BinKey(tag, nbytes)];
+        if (bin.empty()) {
+            _bin_sizes.insert(BinKey(tag, nbytes));
         }
-        _segments.erase(first, last);
+        bin.push_back(std::prev(_segments.end()));
+        _cache_size += nbytes;
     }
 
     /** Evict a memory allocation from the cache
@@ -99,53 +156,158 @@ private:
      * @param position Iterator pointing to the allocation
      * @param call_free When true, the memory allocations are also freed
      */
-    void _evict(std::vector<Segment>::iterator position, bool call_free) {
-        _evict(position, std::next(position), call_free);
+    void _evict(SegmentIter position, bool call_free) {
+        const uint64_t nbytes = position->nbytes;
+        const BinKey key(position->tag, nbytes);
+        auto bin_it = _bins.find(key);
+        assert(bin_it != _bins.end());
+        std::deque<SegmentIter> &bin = bin_it->second;
+        // Since the bin order matches `_segments`, the segment is typically at one of the ends of the bin
+        if (bin.back() == position) {
+            bin.pop_back();
+        } else if (bin.front() == position) {
+            bin.pop_front();
+        } else {
+            bin.erase(std::find(bin.begin(), bin.end(), position));
+        }
+        if (bin.empty()) {
+            _bins.erase(bin_it);
+            _bin_sizes.erase(key);
+        }
+        if (call_free) {
+            _free(position->mem, nbytes, position->tag);
+        }
+        _cache_size -= nbytes;
+        _segments.erase(position);
     }
 
-    /** Evict a memory allocation from the cache
-     * 
-     * @param position Reverse iterator pointing to the allocation
-     * @param call_free When true, the memory allocations are also freed
+    /** Find the best cached segment with tag `tag` that can hold `nbytes`
+     *
+     * @param nbytes Number of bytes requested
+     * @param tag The tag of the segment
+     * @return Iterator to the segment or `_segments.end()` if no segment were found
+     */
+    SegmentIter _find(uint64_t nbytes, int tag) {
+        // Exact size match is the common case, which is a hash lookup
+        auto bin_it = _bins.find(BinKey(tag, nbytes));
+        if (bin_it != _bins.end()) {
+            return bin_it->second.back(); // The most recently used segment of that size
+        }
+        if (_tolerance <= 0 and _split_granularity == 0) {
+            return _segments.end();
+        }
+        // Otherwise, we scan the bins upward from `nbytes` for the smallest segment within the size tolerance.
+        // Beyond the tolerance, only a segment we can split will do and we give up after `MAX_SPLIT_SCAN` bins.
+        const uint64_t tolerated = nbytes + static_cast<uint64_t>(nbytes * _tolerance);
+        int split_scan = 0;
+        for (auto size_it = _bin_sizes.lower_bound(BinKey(tag, nbytes));
+             size_it != _bin_sizes.end() and size_it->first == tag; ++size_it) {
+            const uint64_t seg_size = size_it->second;
+            if (seg_size <= tolerated or _splittable(seg_size, nbytes)) {
+                return _bins.at(*size_it).back();
+            }
+            if (_split_granularity == 0 or ++split_scan >= MAX_SPLIT_SCAN) {
+                break;
+            }
+        }
+        return _segments.end();
+    }
+
+    /** Forget the bookkeeping of the handed out allocation `memory`
+     *
+     * @param nbytes The requested size of the allocation, which is updated to its actual size
+     * @param memory The memory allocation
+     * @return The tag of the allocation
      */
-    void _evict(std::vector<Segment>::reverse_iterator position, bool call_free) {
-        // Notice, we need to iterate `position` once when converting from reverse to regular iterator
-        _evict(std::next(position).base(), call_free);
+    int _forget(uint64_t &nbytes, void *memory) {
+        // The allocation might be larger than requested
+        if (not _oversized.empty()) {
+            auto it = _oversized.find(memory);
+            if (it != _oversized.end()) {
+                nbytes = it->second;
+                _oversized.erase(it);
+            }
+        }
+        int tag = 0;
+        if (not _tags.empty()) {
+            auto it = _tags.find(memory);
+            if (it != _tags.end()) {
+                tag = it->second;
+                _tags.erase(it);
+            }
+        }
+        return tag;
+    }
+
+    /** Return `nbytes` rounded up to the split granularity */
+    uint64_t _split_size(uint64_t nbytes) const {
+        assert(_split_granularity > 0);
+        return (nbytes + _split_granularity - 1) / _split_granularity * _split_granularity;
+    }
+
+    /** Return true when a segment of size `seg_size` can be split into a segment that can hold `nbytes` */
+    bool _splittable(uint64_t seg_size, uint64_t nbytes) const {
+        return _split_granularity > 0 and seg_size % _split_granularity == 0 and _split_size(nbytes) < seg_size;
     }
 
 public:
+    // The default size tolerance (see setTolerance())
+    static constexpr double DEFAULT_TOLERANCE = 0.12;
 
     /** Constructor
      *
      * @param func_alloc A function that takes size and returns a new memory allocation
      * @param func_free  A function that takes a memory allocation and size and frees the allocation
      * @param limit_num_bytes The size limit of the cache (see setLimit())
+     * @param tolerance The size tolerance when reusing segments (see setTolerance())
+     * @param split_granularity The granularity in bytes in which segments can be split or zero if `func_free`
+     *                          cannot free parts of an allocation (e.g. for device buffers)
      */
-    MallocCache(FuncAllocT func_alloc, FuncFreeT func_free, uint64_t limit_num_bytes) :
-            _func_alloc(func_alloc), _func_free(func_free), _mem_allocated_limit(limit_num_bytes) {}
+    MallocCache(FuncAllocT func_alloc, FuncFreeT func_free, uint64_t limit_num_bytes,
+                double tolerance = DEFAULT_TOLERANCE, uint64_t split_granularity = 0) :
+            _func_alloc([func_alloc](uint64_t nbytes, int tag) { return func_alloc(nbytes); }),
+            _func_free([func_free](void *mem, uint64_t nbytes, int tag) { func_free(mem, nbytes); }),
+            _mem_allocated_limit(limit_num_bytes), _tolerance(tolerance), _split_granularity(split_granularity) {}
+
+    /** Constructor where `func_alloc` also takes the tag of the allocation (see alloc())
+     *  The rest of the arguments are the same as above.
+     */
+    MallocCache(FuncTaggedAllocT func_alloc, FuncFreeT func_free, uint64_t limit_num_bytes,
+                double tolerance = DEFAULT_TOLERANCE, uint64_t split_granularity = 0) :
+            _func_alloc(func_alloc),
+            _func_free([func_free](void *mem, uint64_t nbytes, int tag) { func_free(mem, nbytes); }),
+            _mem_allocated_limit(limit_num_bytes), _tolerance(tolerance), _split_granularity(split_granularity) {}
+
+    /** Constructor where both `func_alloc` and `func_free` also take the tag of the allocation
+     *  The rest of the arguments are the same as above.
+     */
+    MallocCache(FuncTaggedAllocT func_alloc, FuncTaggedFreeT func_free, uint64_t limit_num_bytes,
+                double tolerance = DEFAULT_TOLERANCE, uint64_t split_granularity = 0) :
+            _func_alloc(func_alloc), _func_free(func_free), _mem_allocated_limit(limit_num_bytes),
+            _tolerance(tolerance), _split_granularity(split_granularity) {}
 
     /** Pretty print the cache */
     std::string pprint() {
         std::stringstream ss;
         ss << "Malloc Cache: \n";
         for (const Segment &seg: _segments) {
-            ss << "  (" << seg.nbytes << "B, " << seg.mem << ")\n";
+            ss << "  (" << seg.nbytes << "B, " << seg.mem << ", tag " << seg.tag << ")\n";
         }
         return ss.str();
     }
 
     /** Shrink to size of the cache with at least `nbytes`
+     * NB: the least recently used segments are evicted first
      *
      * @param nbytes The minimum amount of bytes to shrink with
      * @return The actual size reduction
      */
     uint64_t shrink(uint64_t nbytes) {
         uint64_t count = 0;
-        std::vector<Segment>::iterator it;
-        for (it = _segments.begin(); it != _segments.end() and count < nbytes; ++it) {
-            count += it->nbytes;
+        while (not _segments.empty() and count < nbytes) {
+            count += _segments.front().nbytes;
+            _evict(_segments.begin(), true);
         }
-        _evict(_segments.begin(), it, true);
         return count;
     }
 
@@ -181,28 +343,45 @@ public:
     /** Alloc a memory allocation of size `nbytes`
      *
      * @param nbytes Number of bytes to allocate
+     * @param tag Only cached segments with this tag are reused and a new allocation gets this tag
      * @return The memory allocation
      */
-    void *alloc(uint64_t nbytes) {
+    void *alloc(uint64_t nbytes, int tag = 0) {
         if (nbytes == 0) {
             return nullptr;
         }
         ++_stat_lookups;
-        // Check for segment of size `nbytes`, which is a cache hit!
-        for (auto it = _segments.rbegin(); it != _segments.rend(); ++it) { // Search in reverse
-            if (it->nbytes == nbytes) {
-                void *ret = it->mem;
-                assert(ret != nullptr);
-                _evict(it, false);
-                return ret;
+        SegmentIter it = _find(nbytes, tag);
+        if (it != _segments.end()) { // Cache hit!
+            void *ret = it->mem;
+            uint64_t seg_size = it->nbytes;
+            assert(ret != nullptr);
+            assert(seg_size >= nbytes);
+            _evict(it, false);
+            if (seg_size > nbytes and _splittable(seg_size, nbytes) and
+                seg_size > nbytes + static_cast<uint64_t>(nbytes * _tolerance)) {
+                // The segment is too large, thus we return the tail of the segment to the cache
+                const uint64_t head = _split_size(nbytes);
+                _insert(seg_size - head, static_cast<char *>(ret) + head, tag);
+                seg_size = head;
+            }
+            if (seg_size != nbytes) {
+                _oversized[ret] = seg_size;
             }
+            if (tag != 0) {
+                _tags[ret] = tag;
+            }
+            return ret;
         }
         ++_stat_misses;
 
         // Since we are allocating new memory, we might have to shrink to fit `_mem_allocated_limit`
         shrinkToFitLimit(nbytes);
 
-        void *ret = _malloc(nbytes); // Cache miss
+        void *ret = _malloc(nbytes, tag); // Cache miss
+        if (tag != 0) {
+            _tags[ret] = tag;
+        }
         return ret;
     }
 
@@ -212,16 +391,24 @@ public:
      * @param memory The memory allocation
      */
     void free(uint64_t nbytes, void *memory) {
+        int tag = _forget(nbytes, memory);
         if (_mem_allocated_limit == 0) {
-            _free(memory, nbytes);
+            _free(memory, nbytes, tag);
         } else {
-            // Insert the segment at the end of `_segments`
-            Segment seg{nbytes, memory};
-            _segments.push_back(seg);
-            _cache_size += nbytes;
+            _insert(nbytes, memory, tag);
         }
     }
 
+    /** Frees a memory allocation of size `nbytes` immediately without retaining it in the cache
+     *
+     * @param nbytes The size of the memory allocation
+     * @param memory The memory allocation
+     */
+    void release(uint64_t nbytes, void *memory) {
+        int tag = _forget(nbytes, memory);
+        _free(memory, nbytes, tag);
+    }
+
     /** Destructor */
     ~MallocCache() {
         shrinkToFit(0);
@@ -239,6 +426,15 @@ public:
         shrinkToFitLimit();
     };
 
+    /** Set the size tolerance of this cache. A request of `nbytes` might reuse a cached segment of up to
+     * `nbytes * (1 + tolerance)` bytes. Use zero to only reuse segments of the exact size.
+     *
+     * @param tolerance The tolerance as a fraction of the requested size
+     */
+    void setTolerance(double tolerance) {
+        _tolerance = tolerance;
+    }
+
     uint64_t getTotalNumBytes() const {
         return _cache_size;
     }
@@ -254,6 +450,11 @@ public:
     uint64_t getMaxMemAllocated() const {
         return _stat_allocated_max;
     }
+
+    /** Return the maximum memory allocated of each tag */
+    const std::map<int, uint64_t> &getMaxMemAllocatedPerTag() const {
+        return _stat_allocated_max_per_tag;
+    }
 };
 
 
@@ -25,36 +25,227 @@ If not, see <http://www.gnu.org/licenses/>.
 #include <functional>
 #include <numeric>
 #include <ostream>
-#include <boost/container/static_vector.hpp>
+#include <iterator>
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
+#include <stdexcept>
+#include <cstdint>
 #include <sstream>
 
 /// The maximum number of possible dimension in arrays.
 constexpr int64_t BH_MAXDIM = 16;
 
 
-/** We use a static allocated vector with a maximum capacity of `BH_MAXDIM`
+/** A statically allocated vector with a maximum capacity of `N`, which is `BH_MAXDIM` by default.
     Notice, `BhStaticVector<T>` and `std::vector<T>` is interchangeable as long
-    as the vector is smaller than `BH_MAXDIM`.
+    as the vector is smaller than `N`.
+
+    The vector is trivially copyable when `T` is, thus it can be copied with `memcpy()`. The unused elements are
+    always value-initialized (zero), which makes it possible to compare vectors of integral type with a fixed size
+    loop without early exit that the compiler can vectorize. Because of this initialization, the vector is not
+    trivially default-constructible thus it is not a POD.
 */
-template<typename T>
-class BhStaticVector : public boost::container::static_vector<T, BH_MAXDIM> {
+template<typename T, std::size_t N = BH_MAXDIM>
+class BhStaticVector {
 public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    BhStaticVector() = default;
+
+    /// Construct a vector of `count` value-initialized elements
+    explicit BhStaticVector(size_type count) {
+        resize(count);
+    }
+
+    /// Construct a vector of `count` copies of `value`
+    BhStaticVector(size_type count, const T &value) {
+        resize(count, value);
+    }
+
+    /// Construct a vector of the elements in the range [first, last)
+    template<typename InputIt, typename = typename std::enable_if<not std::is_integral<InputIt>::value>::type>
+    BhStaticVector(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    /// Construct a vector of the elements in `list`
+    BhStaticVector(std::initializer_list<T> list) : BhStaticVector(list.begin(), list.end()) {}
+
+    constexpr size_type size() const { return _size; }
+
+    constexpr bool empty() const { return _size == 0; }
+
+    static constexpr size_type capacity() { return N; }
+
+    static constexpr size_type max_size() { return N; }
+
+    T *data() { return _data; }
+
+    const T *data() const { return _data; }
+
+    iterator begin() { return _data; }
+
+    const_iterator begin() const { return _data; }
+
+    const_iterator cbegin() const { return _data; }
+
+    iterator end() { return _data + _size; }
+
+    const_iterator end() const { return _data + _size; }
+
+    const_iterator cend() const { return _data + _size; }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    T &operator[](size_type i) { return _data[i]; }
+
+    constexpr const T &operator[](size_type i) const { return _data[i]; }
+
+    T &at(size_type i) {
+        if (i >= _size) {
+            throw std::out_of_range("BhStaticVector::at()");
+        }
+        return _data[i];
+    }
+
+    const T &at(size_type i) const {
+        if (i >= _size) {
+            throw std::out_of_range("BhStaticVector::at()");
+        }
+        return _data[i];
+    }
+
+    T &front() { return _data[0]; }
+
+    const T &front() const { return _data[0]; }
+
+    T &back() { return _data[_size - 1]; }
 
-    // This is C++11 syntax for exposing the constructor from the parent class
-    using boost::container::static_vector<T, BH_MAXDIM>::static_vector;
+    const T &back() const { return _data[_size - 1]; }
+
+    void push_back(const T &value) {
+        check_capacity(_size + 1);
+        _data[_size++] = value;
+    }
+
+    template<typename... Args>
+    void emplace_back(Args &&... args) {
+        check_capacity(_size + 1);
+        _data[_size++] = T(std::forward<Args>(args)...);
+    }
+
+    void pop_back() {
+        _data[--_size] = T{};
+    }
+
+    void clear() {
+        std::fill(begin(), end(), T{});
+        _size = 0;
+    }
+
+    void resize(size_type count, const T &value = T{}) {
+        check_capacity(count);
+        if (count > _size) {
+            std::fill(_data + _size, _data + count, value);
+        } else {
+            std::fill(_data + count, _data + _size, T{});
+        }
+        _size = count;
+    }
+
+    /// Insert `value` before `pos` and return an iterator to the inserted element
+    iterator insert(const_iterator pos, const T &value) {
+        check_capacity(_size + 1);
+        const auto i = static_cast<size_type>(pos - begin());
+        const T tmp = value; // NB: `value` might be an element of this vector
+        std::copy_backward(_data + i, _data + _size, _data + _size + 1);
+        _data[i] = tmp;
+        ++_size;
+        return _data + i;
+    }
+
+    /// Insert `count` copies of `value` before `pos` and return an iterator to the first inserted element
+    iterator insert(const_iterator pos, size_type count, const T &value) {
+        check_capacity(_size + count);
+        const auto i = static_cast<size_type>(pos - begin());
+        const T tmp = value; // NB: `value` might be an element of this vector
+        std::copy_backward(_data + i, _data + _size, _data + _size + count);
+        std::fill(_data + i, _data + i + count, tmp);
+        _size += count;
+        return _data + i;
+    }
+
+    /// Insert the elements in the range [first, last) before `pos` and return an iterator to the first inserted
+    template<typename InputIt, typename = typename std::enable_if<not std::is_integral<InputIt>::value>::type>
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        const auto i = static_cast<size_type>(pos - begin());
+        const BhStaticVector tmp(first, last);
+        check_capacity(_size + tmp.size());
+        std::copy_backward(_data + i, _data + _size, _data + _size + tmp.size());
+        std::copy(tmp.begin(), tmp.end(), _data + i);
+        _size += tmp.size();
+        return _data + i;
+    }
+
+    /// Erase the element at `pos` and return an iterator to the element following it
+    iterator erase(const_iterator pos) {
+        return erase(pos, pos + 1);
+    }
+
+    /// Erase the elements in the range [first, last) and return an iterator to the element following them
+    iterator erase(const_iterator first, const_iterator last) {
+        const auto i = static_cast<size_type>(first - begin());
+        const auto n = static_cast<size_type>(last - first);
+        std::copy(_data + i + n, _data + _size, _data + i);
+        std::fill(_data + _size - n, _data + _size, T{});
+        _size -= n;
+        return _data + i;
+    }
+
+    bool operator==(const BhStaticVector &other) const {
+        return _size == other._size and equal(other, std::is_integral<T>());
+    }
+
+    bool operator!=(const BhStaticVector &other) const {
+        return not(*this == other);
+    }
+
+    /// Lexicographical less than
+    bool operator<(const BhStaticVector &other) const {
+        return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
+    }
 
     /// The sum of the elements in this vector
-    virtual T sum() const {
+    T sum() const {
         return std::accumulate(this->begin(), this->end(), T{0});
     }
 
     /// The product of the elements in this vector
-    virtual T prod() const {
+    T prod() const {
         return std::accumulate(this->begin(), this->end(), T{1}, std::multiplies<T>());
     }
 
     /// Pretty printing of this vector
-    virtual std::string pprint() const {
+    std::string pprint() const {
         std::stringstream ss;
         ss << '(';
         if (!this->empty()) {
@@ -66,14 +257,39 @@ public:
         ss << ')';
         return ss.str();
     }
+
+private:
+    T _data[N]{};
+    size_type _size = 0;
+
+    static void check_capacity(size_type count) {
+        if (count > N) {
+            throw std::length_error("BhStaticVector: the capacity of " + std::to_string(N) + " is exceeded");
+        }
+    }
+
+    // Compare all `N` elements, which the compiler vectorizes since the loop has no early exit and the unused
+    // elements are zero
+    bool equal(const BhStaticVector &other, std::true_type) const {
+        T diff = 0;
+        for (size_type i = 0; i < N; ++i) {
+            diff |= _data[i] ^ other._data[i];
+        }
+        return diff == 0;
+    }
+
+    bool equal(const BhStaticVector &other, std::false_type) const {
+        return std::equal(begin(), end(), other.begin());
+    }
 };
 
 /// Print overload
-template<typename T>
-inline std::ostream &operator<<(std::ostream &o, const BhStaticVector<T> &vec) {
+template<typename T, std::size_t N>
+inline std::ostream &operator<<(std::ostream &o, const BhStaticVector<T, N> &vec) {
     o << vec.pprint();
     return o;
 }
 
 /// The type used throughout Bohrium
-typedef BhStaticVector<int64_t> BhIntVec;
\ No newline at end of file
+typedef BhStaticVector<int64_t> BhIntVec;
+static_assert(std::is_trivially_copyable<BhIntVec>::value, "BhIntVec must be trivially copyable");
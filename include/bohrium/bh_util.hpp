@@ -20,6 +20,8 @@ If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <sstream>
 #include <vector>
 #include <type_traits>
@@ -75,11 +77,68 @@ bool exist_linearly(container_type &container, element_type &element) {
 }
 
 // Remove all files in `dir` but keep some of the newest files.
-void remove_old_files(const boost::filesystem::path &dir, int64_t num_of_newest_to_keep);
+// If `extension` isn't empty, only files with that extension (e.g. ".so") are considered.
+void remove_old_files(const boost::filesystem::path &dir, int64_t num_of_newest_to_keep,
+                      const std::string &extension = "");
 
 // Return the hash of the string `s`.
 // This hash is persistent between different compilers and architectures (incl. 32 and 64-bit)
 uint64_t hash(const char* s, uint64_t seed = 0);
 uint64_t hash(const std::string &s, uint64_t seed = 0);
 
+/** Incremental hash of binary fields, which is much faster than hashing a textual representation.
+ *  The fields are mixed as the 64-bit lanes of xxHash64 thus, like `hash()`, the hash is persistent between
+ *  different compilers and architectures.
+ *  NB: the fields aren't separated thus the caller must make the sequence unambiguous, e.g. by adding lengths.
+ */
+class Hasher {
+private:
+    static constexpr uint64_t PRIME1 = 11400714785074694791ULL;
+    static constexpr uint64_t PRIME2 = 14029467366897019727ULL;
+    static constexpr uint64_t PRIME3 = 1609587929392839161ULL;
+    static constexpr uint64_t PRIME4 = 9650029242287828579ULL;
+    static constexpr uint64_t PRIME5 = 2870177450012600261ULL;
+    uint64_t _state;
+
+    static uint64_t rotl(uint64_t x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+public:
+    explicit Hasher(uint64_t seed = 0) : _state(seed + PRIME5) {}
+
+    /// Add an integral or enum field
+    template<typename T>
+    Hasher &add(T value) {
+        static_assert(std::is_integral<T>::value or std::is_enum<T>::value, "Hasher: only integral fields");
+        uint64_t lane = static_cast<uint64_t>(value) * PRIME2;
+        lane = rotl(lane, 31) * PRIME1;
+        _state = rotl(_state ^ lane, 27) * PRIME1 + PRIME4;
+        return *this;
+    }
+
+    /// Add a floating-point field by its bit pattern
+    Hasher &add(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return add(bits);
+    }
+    Hasher &add(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return add(bits);
+    }
+
+    /// Return the hash of the fields added so far
+    uint64_t digest() const {
+        uint64_t h = _state;
+        h ^= h >> 33;
+        h *= PRIME2;
+        h ^= h >> 29;
+        h *= PRIME3;
+        h ^= h >> 32;
+        return h;
+    }
+};
+
 } // util
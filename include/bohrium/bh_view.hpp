@@ -58,8 +58,12 @@ struct bh_view {
     /// The stride for each dimensions
     BhIntVec stride;
 
-    /// Slide information
-    bh_slide slides;
+    /** Slide information or nullptr when the view doesn't slide.
+     *  NB: the slide is owned by the BhIR of the view (see `BhIR::_slides`) and is shared with the copies of
+     *      the view thus copying a view never allocates. Only the views of the BhIR may be slided
+     *      (see `slide_views()`) and copies outliving their BhIR may only test for the presence of a slide.
+     */
+    bh_slide *slides = nullptr;
 
     /// Default Constructor, which create an empty view that doesn't point to any base array
     bh_view() = default;
@@ -68,9 +72,6 @@ struct bh_view {
     bh_view(bh_base *base, int64_t start, int64_t ndim, BhIntVec shape, BhIntVec stride) :
             base(base), start(start), ndim(ndim), shape(std::move(shape)), stride(std::move(stride)) {}
 
-    /// Copy Constructor
-    bh_view(const bh_view &view);
-
     /// Create a view that represents the whole of `base`
     explicit bh_view(bh_base *base) : bh_view(base, 0, 1, {base->nelem()}, {1}) {}
 
@@ -91,6 +92,7 @@ struct bh_view {
     void remove_axis(int64_t dim);
 
     /// Transposes by swapping the two axes 'axis1' and 'axis2'
+    /// NB: the shared slide isn't transposed
     void transpose(int64_t axis1, int64_t axis2);
 
     /// Return true when this view only represent one element
@@ -108,7 +110,7 @@ struct bh_view {
 
     /// Return true when this view has an active sliding object
     bool hasSlide() const {
-        return not slides.dims.empty();
+        return slides != nullptr;
     }
 
     /// Less than operator
@@ -119,14 +121,9 @@ struct bh_view {
         if (other.start < start) return false;
         if (ndim < other.ndim) return true;
         if (other.ndim < ndim) return false;
-        for (int64_t i = 0; i < ndim; ++i) {
-            if (shape[i] < other.shape[i]) return true;
-            if (other.shape[i] < shape[i]) return false;
-        }
-        for (int64_t i = 0; i < ndim; ++i) {
-            if (stride[i] < other.stride[i]) return true;
-            if (other.stride[i] < stride[i]) return false;
-        }
+        // NB: views of the same base and start typically have equal shapes, which the vectorized equality detects
+        if (shape != other.shape) return shape < other.shape;
+        if (stride != other.stride) return stride < other.stride;
         return false;
     }
 
@@ -156,7 +153,9 @@ struct bh_view {
             ar << ndim;
             ar << boost::serialization::make_array(shape.data(), shape.size());
             ar << boost::serialization::make_array(stride.data(), stride.size());
-            ar << slides;
+            // NB: like the base array, the slide is written as its address (see `BhIR::writeSerializedArchive()`)
+            tmp = reinterpret_cast<size_t>(slides);
+            ar << tmp;
         }
     }
 
@@ -175,7 +174,8 @@ struct bh_view {
             stride.resize(static_cast<size_t>(ndim));
             ar >> boost::serialization::make_array(shape.data(), shape.size());
             ar >> boost::serialization::make_array(stride.data(), stride.size());
-            ar >> slides;
+            ar >> tmp;
+            slides = reinterpret_cast<bh_slide *>(tmp);
         }
     }
 
@@ -190,6 +190,8 @@ struct bh_view {
     };
 };
 
+static_assert(std::is_trivially_copyable<bh_view>::value, "bh_view must be trivially copyable");
+
 /// Implements pprint of views
 std::ostream &operator<<(std::ostream &out, const bh_view &v);
 
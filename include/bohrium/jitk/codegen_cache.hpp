@@ -21,6 +21,7 @@ If not, see <http://www.gnu.org/licenses/>.
 
 #include <map>
 #include <string>
+#include <boost/filesystem/path.hpp>
 
 #include <bohrium/bh_instruction.hpp>
 #include <bohrium/jitk/block.hpp>
@@ -35,10 +36,40 @@ private:
     std::map<size_t, std::string> _cache;
     // Some statistics
     jitk::Statistics &stat;
+
+    // Directory of the persistent cache (empty when disabled)
+    boost::filesystem::path _persistent_dir;
+    // Hash of the configuration, which is part of the filenames in the persistent cache
+    uint64_t _config_hash = 0;
+    // Never write to the persistent cache
+    bool _readonly = true;
+
+    // Returns the path to the file of `lookup_hash` in the persistent cache
+    boost::filesystem::path persistentPath(uint64_t lookup_hash) const;
 public:
     // The constructor takes the statistic object
     explicit CodegenCache(jitk::Statistics &stat) : stat(stat) {}
 
+    /** Enable the persistent cache, which shares source code between processes through files in `dir`
+     *
+     * @param dir         The cache directory
+     * @param config_hash Hash of the configuration used when generating code
+     * @param readonly    Never write to `dir`
+     */
+    void enablePersistence(boost::filesystem::path dir, uint64_t config_hash, bool readonly) {
+        _persistent_dir = std::move(dir);
+        _config_hash = config_hash;
+        _readonly = readonly;
+    }
+
+    /** Return the hash of `kernel`, which identifies the source code `symbols` generates
+     *
+     * @param kernel  The kernel
+     * @param symbols The symbol table
+     * @return The hash
+     */
+    static uint64_t hash(const LoopB &kernel, const SymbolTable &symbols);
+
     /** Check the cache for a source code that matches `kernel`
      *
      * @param kernel  The kernel
@@ -47,13 +78,12 @@ public:
      */
     std::pair<std::string, uint64_t> lookup(const LoopB &kernel, const SymbolTable &symbols);
 
-    /** Insert `source` as a hit when requesting `kernel`
+    /** Insert `source` as a hit when requesting the kernel of `lookup_hash`
      *
-     * @param source  The source code
-     * @param kernel  The kernel
-     * @param symbols The symbol table
+     * @param source      The source code
+     * @param lookup_hash The hash of the kernel returned by `lookup()`, which saves hashing the kernel again
      */
-    void insert(std::string source, const LoopB &kernel, const SymbolTable &symbols);
+    void insert(std::string source, uint64_t lookup_hash);
 };
 
 } // jit
@@ -61,6 +61,15 @@ boost::filesystem::path write_source2file(const std::string &src,
                                           const std::string &filename,
                                           bool verbose);
 
+// Write `data` to `path` atomically by writing to a unique file in the same directory, which is then renamed to
+// `path`. Thus, processes sharing a directory never see a partially written file.
+// Returns false on failure e.g. if the directory is read-only.
+bool write_file_atomically(const boost::filesystem::path &path, const std::string &data);
+
+// Read the file at `path` into `out` through a read-only memory map.
+// Returns false if the file doesn't exist or cannot be read.
+bool read_file_mapped(const boost::filesystem::path &path, std::string &out);
+
 // Returns the path to the tmp dir
 boost::filesystem::path get_tmp_path(const ConfigParser &config);
 
@@ -81,5 +90,12 @@ bool row_major_access(const bh_instruction &instr);
 // Transpose the instructions in `instr_list` to make them access column major style
 void to_column_major(std::vector<bh_instruction> &instr_list);
 
+// The maximum span of the output of a reduction that gets an array section reduction, which gives each thread
+// a private copy of the output (see `array_section_span()`)
+constexpr uint64_t ARRAY_SECTION_MAX_SPAN = 4096;
+
+// The number of elements between the first and the last element of 'view' (both included)
+uint64_t array_section_span(const bh_view &view);
+
 } // jitk
 } // bohrium
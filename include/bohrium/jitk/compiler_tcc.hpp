@@ -0,0 +1,83 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+namespace bohrium {
+namespace jitk {
+
+/** Compiler that compiles C99 source in-process to memory using libtcc (the Tiny C Compiler).
+ *  The library is loaded with `dlopen()` at runtime thus Bohrium doesn't depend on libtcc at build time.
+ *  NB: libtcc ignores OpenMP pragmas and cannot parse <complex.h> and <tgmath.h>, thus the caller should
+ *      use the regular `Compiler` for such sources and when `compile()` fails.
+ */
+class CompilerTCC {
+    // The libtcc library and its functions
+    void *_lib = nullptr;
+    void *(*_tcc_new)() = nullptr;
+    void (*_tcc_delete)(void *) = nullptr;
+    void (*_tcc_set_error_func)(void *, void *, void (*)(void *, const char *)) = nullptr;
+    int (*_tcc_set_output_type)(void *, int) = nullptr;
+    int (*_tcc_add_include_path)(void *, const char *) = nullptr;
+    void (*_tcc_define_symbol)(void *, const char *, const char *) = nullptr;
+    int (*_tcc_compile_string)(void *, const char *) = nullptr;
+    int (*_tcc_relocate)(void *, void *) = nullptr;
+    void *(*_tcc_get_symbol)(void *, const char *) = nullptr;
+
+    // Include paths and macros (`-I` and `-D` flags of the compile command)
+    std::vector<std::string> _include_paths;
+    std::vector<std::pair<std::string, std::string> > _defines;
+
+    // The compiled kernels live in the memory of their states, which we keep until destruction
+    std::vector<void *> _states;
+
+    // libtcc isn't thread-safe
+    mutable std::mutex _mutex;
+
+public:
+    bool verbose = false;
+
+    /** Constructor that loads libtcc
+     *
+     * @param cmd_template The compile command of the regular compiler, which we take the `-I` and `-D` flags from
+     * @param lib_path The path or name of the libtcc shared library
+     * @param verbose Print the compile errors
+     */
+    CompilerTCC(const std::string &cmd_template, const std::string &lib_path, bool verbose);
+
+    ~CompilerTCC();
+
+    CompilerTCC(const CompilerTCC &) = delete;
+    CompilerTCC &operator=(const CompilerTCC &) = delete;
+
+    /** Compile `source` to memory and return the address of `func_name`
+     *
+     * @param source The source to compile
+     * @param func_name The name of the function to return
+     * @return The function address or nullptr if libtcc couldn't compile `source`
+     */
+    void *compile(const std::string &source, const std::string &func_name);
+};
+
+}
+}
@@ -18,14 +18,27 @@ GNU Lesser General Public License along with Bohrium.
 If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <map>
+
 void slide_views(BhIR *bhir) {
+    // Views that share a slide are copies of the same view thus only the first is slided and the rest copies it
+    std::map<const bh_slide *, const bh_view *> slided;
+
     // Iterate through all instructions and slide the relevant views
     for (bh_instruction &instr : bhir->instr_list) {
         for (bh_view &view : instr.operand) {
             if (view.hasSlide()) {
+                auto first = slided.find(view.slides);
+                if (first != slided.end()) {
+                    view.start = first->second->start;
+                    view.shape = first->second->shape;
+                    continue;
+                }
+                slided[view.slides] = &view;
+
                 // The relevant dimension in the view is updated by the given stride
-                for (const bh_slide_dim &dim: view.slides.dims) {
-                    if (dim.step_delay == 1 || (view.slides.iteration_counter % dim.step_delay == dim.step_delay-1)) {
+                for (const bh_slide_dim &dim: view.slides->dims) {
+                    if (dim.step_delay == 1 || (view.slides->iteration_counter % dim.step_delay == dim.step_delay-1)) {
                         if (dim.stride) {
                             int64_t change = dim.offset_change*dim.stride;
                             int64_t max_rel_idx = dim.stride*dim.shape;
@@ -39,13 +52,13 @@ void slide_views(BhIR *bhir) {
                             view.start += change;
 
                             // We may have to reset the iteration
-                            auto it = view.slides.resets.find(dim.rank);
-                            if (it != view.slides.resets.end()) {
+                            auto it = view.slides->resets.find(dim.rank);
+                            if (it != view.slides->resets.end()) {
                                 const int64_t reset_at = it->second.first;
                                 int64_t &changes_since_reset = it->second.second;
                                 changes_since_reset += change;
-                                if (view.slides.iteration_counter > 0) {
-                                    if ((view.slides.iteration_counter / dim.step_delay) % reset_at == reset_at - 1) {
+                                if (view.slides->iteration_counter > 0) {
+                                    if ((view.slides->iteration_counter / dim.step_delay) % reset_at == reset_at - 1) {
                                         view.start -= changes_since_reset;
                                         changes_since_reset = 0;
                                         view.shape[dim.rank] -= reset_at * dim.shape_change;
@@ -60,7 +73,7 @@ void slide_views(BhIR *bhir) {
                         }
                     }
                 }
-                view.slides.iteration_counter += 1;
+                view.slides->iteration_counter += 1;
             }
         }
     }
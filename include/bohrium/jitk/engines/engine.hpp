@@ -54,9 +54,12 @@ protected:
     const bool use_volatile;
     const bool array_contraction;
 
-    // Maximum number of cache files
+    // Maximum number of kernel binaries in the cache dir
     const int64_t cache_file_max;
 
+    // Maximum number of persistent fuse and codegen cache files, which is separate from `cache_file_max`
+    const int64_t persistent_cache_file_max;
+
     // Path to a temporary directory for the source and object files
     const boost::filesystem::path tmp_dir;
 
@@ -73,6 +76,9 @@ protected:
     // use this option to avoid write conflicts by only having rank zero write to the cache dir.
     const bool cache_readonly;
 
+    // Set to true, if the fuse and codegen caches are stored in the cache dir
+    bool persistent_cache{false};
+
     // The hash of the JIT compilation command
     uint64_t compilation_hash{0};
 
@@ -95,6 +101,7 @@ public:
             use_volatile{comp.config.defaultGet<bool>("volatile", false)},
             array_contraction{comp.config.defaultGet<bool>("array_contraction", true)},
             cache_file_max(comp.config.defaultGet<int64_t>("cache_file_max", 50000)),
+            persistent_cache_file_max(comp.config.defaultGet<int64_t>("persistent_cache_file_max", 50000)),
             tmp_dir(get_tmp_path(comp.config)),
             tmp_src_dir(tmp_dir / "src"),
             tmp_bin_dir(tmp_dir / "obj"),
@@ -106,10 +113,23 @@ public:
         jitk::create_directories(tmp_bin_dir);
         if (not cache_bin_dir.empty()) {
             jitk::create_directories(cache_bin_dir);
+
+            // The fuse and codegen caches share the cache dir, which makes them persistent between executions
+            persistent_cache = comp.config.defaultGet<bool>("persistent_cache", false);
+            if (persistent_cache) {
+                const uint64_t config_hash = util::hash(comp.config.getSectionAsString());
+                fcache.enablePersistence(cache_bin_dir, config_hash, cache_readonly);
+                codegen_cache.enablePersistence(cache_bin_dir, config_hash, cache_readonly);
+            }
         }
     }
 
-    virtual ~Engine() = default;
+    virtual ~Engine() {
+        if (persistent_cache and not cache_readonly and persistent_cache_file_max != -1) {
+            util::remove_old_files(cache_bin_dir, persistent_cache_file_max, ".fuse");
+            util::remove_old_files(cache_bin_dir, persistent_cache_file_max, ".src");
+        }
+    }
 
     /** Return general information of the engine (should be human readable) */
     virtual std::string info() const = 0;
@@ -192,6 +212,21 @@ protected:
                                 const std::vector<uint64_t> &thread_stack,
                                 std::stringstream &out) = 0;
 
+    /** Write source code after the closing brace of a loop, which makes it possible for `loopHeadWriter()` to
+     *  wrap the loop in a code block. The default implementation writes nothing.
+     *
+     * @param symbols       The symbol table
+     * @param scope         The scope
+     * @param block         The block
+     * @param thread_stack  A vector that specifies the amount of parallelism in each nest level (excl. rank -1)
+     * @param out           The stream output
+     */
+    virtual void loopTailWriter(const SymbolTable &symbols,
+                                Scope &scope,
+                                const LoopB &block,
+                                const std::vector<uint64_t> &thread_stack,
+                                std::stringstream &out) {}
+
     /** Write the source code of an instruction
      *
      * @param scope     The scope
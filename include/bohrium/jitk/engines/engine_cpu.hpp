@@ -21,9 +21,17 @@ If not, see <http://www.gnu.org/licenses/>.
 
 #include "engine.hpp"
 
+#include <map>
+#include <set>
+#include <mutex>
+#include <memory>
+#include <functional>
+
 #include <bohrium/bh_config_parser.hpp>
 #include <bohrium/jitk/statistics.hpp>
 #include <bohrium/jitk/apply_fusion.hpp>
+#include <bohrium/jitk/task_scheduler.hpp>
+#include <bohrium/jitk/memory_planner.hpp>
 
 #include <bohrium/bh_view.hpp>
 #include <bohrium/bh_component.hpp>
@@ -37,8 +45,79 @@ class EngineCPU : public Engine {
 protected:
     // In order to avoid duplicate calls to `ConfigParser`, we store config settings here
     const FusionConfig fusion_config;
+    // Thread pool that executes independent kernels concurrently (nullptr when `task_parallel` is disabled)
+    std::unique_ptr<TaskScheduler> task_scheduler;
+    // `bh_data_malloc()` and `bh_data_free()` aren't thread-safe, which matters when `task_scheduler` is used
+    std::mutex memory_mutex;
+    // Place the arrays that are allocated and freed within a BhIR in one arena (see `MemoryPlan`)?
+    const bool memory_planner;
+    // Use the sizes of the loops as variables thus kernels are reused across array sizes?
+    const bool shape_as_var;
+    // Number of executions with the same sizes that makes a kernel get a variant with the sizes as literals
+    // (0 disables the specialization)
+    const uint64_t shape_specialize_threshold;
+    // Number of executions of each kernel and loop sizes (see `specializeShape()`)
+    std::map<uint64_t, uint64_t> shape_executions;
+
+    // Count an execution of the kernel `codegen_hash` with the loop sizes of `symbols` and return true when
+    // the kernel should be specialized to the sizes
+    bool specializeShape(uint64_t codegen_hash, const SymbolTable &symbols);
+
+    // Hoist the partial index of each loop out of the loops below it (induction variable strength reduction)?
+    const bool index_strength_reduce;
+
+    // Recompile hot kernels with the strides and sizes as literals (tier 1) while the generic kernel (tier 0) runs?
+    const bool tiered_compile;
+    // Number of executions or seconds of execution that makes a kernel hot (0 disables the trigger)
+    const uint64_t tier_up_calls;
+    const double tier_up_seconds;
+    // The executions of each kernel and its strides and sizes, which is the unit of the tiered compilation
+    std::map<uint64_t, KernelStats> tier_stats;
+    // The kernels whose tier 1 is ready
+    std::set<uint64_t> tier_ready;
+    // Protects `tier_stats` when the kernels are executed concurrently
+    std::mutex tier_mutex;
+
+    /** Replace the generic symbol table of `kernel` at the back of `symbol_tables` with a symbol table where the
+     *  strides and sizes are literals, when the kernel is hot and its tier 1 is ready.
+     *  NB: `symbol_tables` must have room for one more symbol table, which must not move
+     *
+     * @return The statistics of the executions of the kernel, which the caller must update
+     */
+    KernelStats *tierUp(const LoopB &kernel, std::vector<SymbolTable> &symbol_tables);
+
+    // Return the source code and codegen hash of `kernel` using the codegen cache
+    std::pair<std::string, uint64_t> getSource(const LoopB &kernel, const SymbolTable &symbols);
+
+    // Execute `kernel_list` on `task_scheduler` where kernels that don't depend on each other run concurrently.
+    // Arrays are freed through `plan`, whose dependencies are added to the kernel DAG.
+    void executeTaskParallel(const std::vector<LoopB> &kernel_list,
+                             const std::vector<SymbolTable> &symbol_tables,
+                             const std::vector<std::string> &sources,
+                             const std::vector<uint64_t> &codegen_hashes,
+                             const std::vector<KernelStats *> &kernel_stats,
+                             MemoryPlan &plan);
 public:
-    EngineCPU(component::ComponentVE &comp, Statistics &stat) : Engine(comp, stat), fusion_config(comp.config, false) {}
+    EngineCPU(component::ComponentVE &comp, Statistics &stat) : Engine(comp, stat), fusion_config(comp.config, false),
+                                                                memory_planner(comp.config.defaultGet<bool>(
+                                                                        "memory_planner", false)),
+                                                                shape_as_var(comp.config.defaultGet<bool>(
+                                                                        "shape_as_var", false)),
+                                                                shape_specialize_threshold(
+                                                                        comp.config.defaultGet<uint64_t>(
+                                                                                "shape_specialize_threshold", 10)),
+                                                                index_strength_reduce(comp.config.defaultGet<bool>(
+                                                                        "index_strength_reduce", false)),
+                                                                tiered_compile(comp.config.defaultGet<bool>(
+                                                                        "tiered_compile", false)),
+                                                                tier_up_calls(comp.config.defaultGet<uint64_t>(
+                                                                        "tier_up_calls", 100)),
+                                                                tier_up_seconds(comp.config.defaultGet<double>(
+                                                                        "tier_up_seconds", 1.0)) {
+        if (comp.config.defaultGet<bool>("task_parallel", false)) {
+            task_scheduler.reset(new TaskScheduler(comp.config.defaultGet<uint64_t>("task_parallel_threads", 4)));
+        }
+    }
 
     ~EngineCPU() override = default;
 
@@ -48,11 +127,53 @@ public:
                              uint64_t codegen_hash,
                              std::stringstream &ss) = 0;
 
-    virtual void execute(const jitk::SymbolTable &symbols,
+    /** Prepare the execution of the kernels of a BhIR, which is called before any of them are executed.
+     *  The default implementation does nothing but an engine can use it to compile all new kernels at once.
+     *
+     * @param kernels        The (non-system-only) kernels
+     * @param sources        The source code of each kernel
+     * @param codegen_hashes The codegen hash of each kernel
+     */
+    virtual void prepare(const std::vector<const LoopB *> &kernels,
+                         const std::vector<std::string> &sources,
+                         const std::vector<uint64_t> &codegen_hashes) {}
+
+    /** Return true when the tier 1 kernel `source` is compiled and ready. Otherwise, its compilation is started
+     *  in the background and the generic kernel is used meanwhile. The default implementation compiles
+     *  when the kernel is executed thus the tier 1 kernel is always ready.
+     *
+     * @param source       The source code of the tier 1 kernel
+     * @param codegen_hash The codegen hash of the tier 1 kernel
+     */
+    virtual bool tierReady(const std::string &source, uint64_t codegen_hash) {
+        return true;
+    }
+
+    virtual void execute(const LoopB &kernel,
+                         const jitk::SymbolTable &symbols,
                          const std::string &source,
                          uint64_t codegen_hash,
                          const std::vector<const bh_instruction *> &constants) = 0;
 
+    /** Return a function that executes `kernel`, which might be called concurrently with the functions of
+     *  kernels that don't depend on `kernel`. Compilation must be done before returning whereas the arrays of
+     *  the kernel are allocated by the function (under `memory_mutex`) thus only when the kernel is ready to run.
+     *  The arguments are the same as `execute()`.
+     */
+    virtual std::function<void()> getLauncher(const LoopB &kernel,
+                                              const jitk::SymbolTable &symbols,
+                                              const std::string &source,
+                                              uint64_t codegen_hash,
+                                              const std::vector<const bh_instruction *> &constants) = 0;
+
+    /** Called by each task of `executeTaskParallel()` before it executes its kernel. Engines with parallel
+     *  kernels should limit the number of threads of the calling thread, such that the concurrent kernels
+     *  don't oversubscribe the CPU. The default does nothing.
+     *
+     * @param num_tasks The number of tasks that are running or ready to run, including the calling task
+     */
+    virtual void limitTaskThreads(size_t num_tasks) {}
+
     void handleExecution(BhIR *bhir) override;
 
     void handleExtmethod(BhIR *bhir) override;
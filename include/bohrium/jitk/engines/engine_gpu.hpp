@@ -223,8 +223,7 @@ private:
         }
         // Notice, we have to re-create free instructions
         for (const bh_base *base: kernel.getAllFrees()) {
-            vector<bh_view> operands = {bh_view(const_cast<bh_base *>(base))};
-            bh_instruction instr(BH_FREE, std::move(operands));
+            bh_instruction instr(BH_FREE, {bh_view(const_cast<bh_base *>(base))});
             child_instr_list.push_back(std::move(instr));
         }
         BhIR tmp_bhir(std::move(child_instr_list), bhir->getSyncs());
@@ -267,7 +266,7 @@ private:
             string source = ss.str();
             stat.time_codegen += chrono::steady_clock::now() - tcodegen;
             execute(symbols, source, lookup.second, thread_stack, constants);
-            codegen_cache.insert(std::move(source), kernel, symbols);
+            codegen_cache.insert(std::move(source), lookup.second);
         }
     }
 };
@@ -39,8 +39,19 @@ struct FusionConfig {
     std::string pre_fuser;
     /// List of fusers to use
     std::vector<std::string> fuser_list;
-    /// When using the greedy fuser, when exceeding `greedy_threshold` nodes fuser_reshapable_first() is used instead.
+    /// When using the cost_model fuser, when exceeding `greedy_threshold` edges fuser_reshapable_first() is used instead.
     uint64_t greedy_threshold;
+    /// The cost model parameters of the `cost_model` fuser (see `graph::CostModel`)
+    uint64_t cost_cache_size;
+    uint64_t cost_par_threshold;
+    double cost_serial_penalty;
+    double cost_cache_penalty;
+    /// Print the cost of the `cost_model` fuser compared to the `greedy` fuser
+    bool cost_benchmark;
+    /// The bytes a tile of the `tile_for_cache` transformer must fit in (0 detects the L1 cache)
+    uint64_t tile_cache_size;
+    /// The bytes a group of tiles of the `tile_for_cache` transformer must fit in (0 detects the L2 cache)
+    uint64_t tile_l2_cache_size;
     /// Dump fusion graph
     bool graph;
 
@@ -50,6 +61,13 @@ struct FusionConfig {
             pre_fuser(config.defaultGet("pre_fuser", std::string("lossy"))),
             fuser_list(config.defaultGetList("fuser_list", {"greedy"})),
             greedy_threshold(config.defaultGet<uint64_t>("greedy_threshold", 10000)),
+            cost_cache_size(config.defaultGet<uint64_t>("cost_cache_size", 256 * 1024)),
+            cost_par_threshold(config.defaultGet<uint64_t>("cost_par_threshold", 1000)),
+            cost_serial_penalty(config.defaultGet<double>("cost_serial_penalty", 4)),
+            cost_cache_penalty(config.defaultGet<double>("cost_cache_penalty", 2)),
+            cost_benchmark(config.defaultGet<bool>("cost_benchmark", false)),
+            tile_cache_size(config.defaultGet<uint64_t>("tile_cache_size", 0)),
+            tile_l2_cache_size(config.defaultGet<uint64_t>("tile_l2_cache_size", 0)),
             graph(config.defaultGet<bool>("graph", false)) {}
 };
 
@@ -78,5 +96,8 @@ void fuser_reshapable_first(std::vector<Block> &block_list, bool avoid_rank0_swe
 // Fuses 'block_list' greedily
 void fuser_greedy(const FusionConfig &config, std::vector<Block> &block_list);
 
+// Fuses 'block_list' greedily minimizing the memory traffic, lost parallelism, and cache overflow of `graph::CostModel`
+void fuser_cost_model(const FusionConfig &config, std::vector<Block> &block_list);
+
 } // jit
 } // bohrium
@@ -21,6 +21,7 @@ If not, see <http://www.gnu.org/licenses/>.
 
 #include <map>
 #include <vector>
+#include <boost/filesystem/path.hpp>
 
 #include <bohrium/bh_instruction.hpp>
 #include <bohrium/jitk/block.hpp>
@@ -39,6 +40,20 @@ private:
     };
     // The hash to payload map
     std::map<size_t, CachePayload> _cache;
+
+    // Directory of the persistent cache (empty when disabled)
+    boost::filesystem::path _persistent_dir;
+    // Hash of the configuration, which is part of the filenames in the persistent cache
+    uint64_t _config_hash = 0;
+    // Never write to the persistent cache
+    bool _readonly = true;
+
+    // Returns the path to the file of `lookup_hash` in the persistent cache
+    boost::filesystem::path persistentPath(size_t lookup_hash) const;
+    // Load `lookup_hash` from the persistent cache into `_cache` and return it (or `_cache.end()` on misses)
+    std::map<size_t, CachePayload>::iterator loadPersistent(size_t lookup_hash);
+    // Write `payload` to the persistent cache
+    void storePersistent(size_t lookup_hash, const CachePayload &payload) const;
 public:
     // Some statistics
     jitk::Statistics &stat;
@@ -46,10 +61,24 @@ public:
     // The constructor takes the statistic object
     FuseCache(jitk::Statistics &stat) : stat(stat) {}
 
-    // Check the cache for a block list that matches 'instr_list'
-    std::pair<std::vector<Block>, bool> get(const std::vector<bh_instruction *> &instr_list);
-    // Insert 'block_list' as a hit when requesting 'instr_list'
-    void insert(const std::vector<bh_instruction *> &instr_list, std::vector<Block> block_list);
+    /** Enable the persistent cache, which shares block lists between processes through files in `dir`
+     *
+     * @param dir         The cache directory
+     * @param config_hash Hash of the configuration used when fusing
+     * @param readonly    Never write to `dir`
+     */
+    void enablePersistence(boost::filesystem::path dir, uint64_t config_hash, bool readonly) {
+        _persistent_dir = std::move(dir);
+        _config_hash = config_hash;
+        _readonly = readonly;
+    }
+
+    // Return the lookup hash of 'instr_list', which is computed once and given to `get()` and `insert()`
+    static uint64_t hash(const std::vector<bh_instruction *> &instr_list);
+    // Check the cache for a block list that matches 'instr_list', which has the lookup hash 'lookup_hash'
+    std::pair<std::vector<Block>, bool> get(const std::vector<bh_instruction *> &instr_list, uint64_t lookup_hash);
+    // Insert 'block_list' as a hit when requesting 'instr_list', which has the lookup hash 'lookup_hash'
+    void insert(const std::vector<bh_instruction *> &instr_list, uint64_t lookup_hash, std::vector<Block> block_list);
 };
 
 
@@ -67,7 +67,7 @@ void merge_system_pendants(DAG &dag);
 // Pretty print the DAG. A "-<id>.dot" is append the filename. Set `id` to -1 for a default unique id
 void pprint(const DAG &dag, const char *filename, bool avoid_rank0_sweep, int id=-1);
 
-// Create a dag based on the 'block_list'
+// Create a dag based on the 'block_list', which may also be a list of kernels (i.e. blocks of rank -1)
 DAG from_block_list(const std::vector <Block> &block_list);
 
 // Create a block list based on the 'dag'
@@ -133,10 +133,51 @@ std::vector<Block> topological(DAG &dag, bool avoid_rank0_sweep) {
     return ret;
 }
 
-// Merges the vertices in 'dag' greedily.
-// 'avoid_rank0_sweep' will avoid fusion of sweeped and non-sweeped blocks at the root level
+/* Merges the vertices in 'dag' greedily by always merging the fusible edge with the greatest weight.
+ * 'avoid_rank0_sweep' will avoid fusion of sweeped and non-sweeped blocks at the root level
+ *
+ * The edges are kept in a priority queue that is updated lazily when merging, transitive edges are removed when
+ * they reach the top of the queue, and path searches are bounded by a dynamically maintained topological order.
+ *
+ * Complexity: O(E log E) plus the path searches, which only visit vertices between the two vertices of an edge
+ */
 void greedy(DAG &dag, bool avoid_rank0_sweep);
 
+/* The cost model that `greedy_cost()` minimizes.
+ * The cost of a block is the bytes its views of non-temporary arrays access, which is multiplied by
+ * `serial_penalty` when the block has less than `par_threshold` threading and by `cache_penalty` when
+ * the working set of one iteration of the block exceeds `cache_size`.
+ * Override `cost()` to implement another cost model.
+ */
+struct CostModel {
+    // Size of the cache in bytes
+    uint64_t cache_size;
+    // Amount of threading below which a block is considered serial
+    uint64_t par_threshold;
+    // Cost multiplier of blocks below `par_threshold`
+    double serial_penalty;
+    // Cost multiplier of blocks with a working set greater than `cache_size`
+    double cache_penalty;
+
+    CostModel(uint64_t cache_size, uint64_t par_threshold, double serial_penalty, double cache_penalty) :
+            cache_size(cache_size), par_threshold(par_threshold), serial_penalty(serial_penalty),
+            cache_penalty(cache_penalty) {}
+
+    virtual ~CostModel() = default;
+
+    // Return the cost of 'block'
+    virtual double cost(const Block &block) const;
+};
+
+// Return the total cost of all vertices in 'dag' using 'model'
+double total_cost(const DAG &dag, const CostModel &model);
+
+// Merges the vertices in 'dag' greedily by always merging the edge that reduces the cost of 'model' the most.
+// Edges that increase the cost are never merged. Like `greedy()`, the edges are kept in a priority queue and
+// only the edges adjacent to a merged vertex are re-evaluated.
+// 'avoid_rank0_sweep' will avoid fusion of sweeped and non-sweeped blocks at the root level
+void greedy_cost(DAG &dag, bool avoid_rank0_sweep, const CostModel &model);
+
 } // graph
 } // jit
 } // bohrium
@@ -22,6 +22,7 @@ If not, see <http://www.gnu.org/licenses/>.
 /** In this file we declare the bohrium::jitk::iterator namespace, which is a collection of use full iterators **/
 
 #include <boost/iterator/iterator_facade.hpp>
+#include <boost/container/static_vector.hpp>
 #include <bohrium/jitk/block.hpp>
 
 
@@ -84,10 +85,10 @@ class BaseList
 private:
     friend class boost::iterator_core_access;
 
-    std::vector<bh_view>::const_iterator cur, begin, end;
+    BhOperandVec::const_iterator cur, begin, end;
 
     // Iterate `it` to the next instruction
-    inline void _next(std::vector<bh_view>::const_iterator &it) {
+    inline void _next(BhOperandVec::const_iterator &it) {
         assert(it != end);
         while (++it != end and it->isConstant()) {}
     }
@@ -123,11 +124,11 @@ private:
 public:
 
     /// Construct an "end" pointer
-    explicit BaseList(std::vector<bh_view>::const_iterator end) : cur(end), begin(end), end(end) {}
+    explicit BaseList(BhOperandVec::const_iterator end) : cur(end), begin(end), end(end) {}
 
     /// Construct based on an instruction list
-    explicit BaseList(const std::vector<bh_view> &view_list) : cur(view_list.begin()), begin(view_list.begin()),
-                                                               end(view_list.end()) {
+    explicit BaseList(const BhOperandVec &view_list) : cur(view_list.begin()), begin(view_list.begin()),
+                                                       end(view_list.end()) {
         // If the first item is a constant, we iterate to the first non-constant
         if ((not view_list.empty()) and view_list.front().isConstant()) {
             increment();
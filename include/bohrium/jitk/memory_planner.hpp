@@ -0,0 +1,107 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+#include <map>
+#include <utility>
+
+#include <bohrium/bh_base.hpp>
+#include <bohrium/jitk/block.hpp>
+#include <bohrium/jitk/symbol_table.hpp>
+
+namespace bohrium {
+namespace jitk {
+
+/** A static memory plan of the kernels of a BhIR.
+ *  The arrays that are both allocated and freed within the kernel list are placed in one arena where arrays
+ *  with non-overlapping live ranges share bytes. The live range of an array goes from the first kernel that
+ *  uses it to the kernel that frees it.
+ */
+class MemoryPlan {
+    struct Placement {
+        size_t first_kernel;  // The first kernel that uses the array
+        size_t free_kernel;   // The kernel that frees the array
+        uint64_t offset;      // The offset into the arena
+        uint64_t nbytes;      // The size including alignment padding
+    };
+    std::map<bh_base *, Placement> _placements;
+    // The arena, which is allocated through the malloc cache like any other array
+    bh_base _arena;
+    // The sum of the sizes of the placed arrays
+    uint64_t _array_bytes = 0;
+
+public:
+    /** Plan the memory of `kernel_list` where `symbol_tables` are the symbol tables of the kernels.
+     *  Arrays already allocated are left alone.
+     *
+     * @param kernel_list   The kernels in execution order
+     * @param symbol_tables The symbol table of each kernel
+     * @param alignment     The alignment in bytes of each array in the arena
+     */
+    MemoryPlan(const std::vector<LoopB> &kernel_list,
+               const std::vector<SymbolTable> &symbol_tables,
+               uint64_t alignment = 64);
+
+    /// An empty plan, which places no arrays
+    MemoryPlan() = default;
+
+    MemoryPlan(MemoryPlan &&other) noexcept : _placements(std::move(other._placements)), _arena(other._arena),
+                                              _array_bytes(other._array_bytes) {
+        other._arena.resetDataPtr();
+    }
+
+    MemoryPlan(const MemoryPlan &) = delete;
+    MemoryPlan &operator=(const MemoryPlan &) = delete;
+
+    ~MemoryPlan();
+
+    /// Allocate the arena and set the data pointers of all placed arrays
+    void allocate();
+
+    /// Free `base`, which only resets the data pointer when `base` is placed in the arena
+    void free(bh_base *base);
+
+    /// Return the arena to the malloc cache. NB: all placed arrays must have been freed
+    void release();
+
+    /// The number of placed arrays
+    size_t numArrays() const {
+        return _placements.size();
+    }
+
+    /// The sum of the sizes of the placed arrays, which is the memory needed without the plan
+    uint64_t arrayBytes() const {
+        return _array_bytes;
+    }
+
+    /// The size of the arena
+    uint64_t arenaBytes() const {
+        return static_cast<uint64_t>(_arena.nelem());
+    }
+
+    /** Return the (from, to) kernel pairs where kernel `to` reuses bytes that kernel `from` frees.
+     *  These dependencies must be respected when kernels are executed out of order.
+     */
+    std::vector<std::pair<size_t, size_t> > dependencies() const;
+};
+
+} // jitk
+} // bohrium
@@ -41,6 +41,8 @@ private:
     std::set<InstrPtr> _omp_atomic; // Set of instructions that should be guarded by OpenMP atomic
     std::set<InstrPtr> _omp_critical; // Set of instructions that should be guarded by OpenMP critical
     std::set<bh_view, OffsetAndStrides_less> _declared_idx; // Set of indexes that have been locally declared
+    std::set<int> _parallel_scans; // Set of loop ranks that are executed as a parallel prefix scan
+    std::set<std::pair<size_t, int> > _partial_idx; // Set of partial indexes (offset-and-strides ID and rank) declared
 public:
     Scope(const SymbolTable &symbols, const Scope *parent) : symbols(symbols), parent(parent) {}
 
@@ -118,6 +120,27 @@ public:
         }
     }
 
+    /// Insert that the loop of rank 'rank' is executed as a parallel prefix scan where each thread starts at `i<rank>_first`
+    void insertParallelScan(int rank) {
+        _parallel_scans.insert(rank);
+    }
+
+    /// Remove 'rank' from the set of parallel prefix scan loops
+    void eraseParallelScan(int rank) {
+        _parallel_scans.erase(rank);
+    }
+
+    /// Check if the loop of rank 'rank' is executed as a parallel prefix scan
+    bool isParallelScan(int rank) const {
+        if (util::exist(_parallel_scans, rank)) {
+            return true;
+        } else if (parent != nullptr) {
+            return parent->isParallelScan(rank);
+        } else {
+            return false;
+        }
+    }
+
     /// Check if 'view' has been locally declared (e.g. a temporary or scalar-replaced variable)
     bool isDeclared(const bh_view &view) const {
         return isTmp(view.base) or isScalarReplaced(view);
@@ -162,6 +185,28 @@ public:
         out << type_str << " " << getName(view) << ";";
     }
 
+    /// Check if the partial index of 'view' that covers the axes up to 'rank' has been locally declared
+    bool isPartialIdxDeclared(const bh_view &view, int rank) const {
+        const std::pair<size_t, int> key(symbols.offsetStridesID(view), rank);
+        if (util::exist(_partial_idx, key)) {
+            return true;
+        } else if (parent != nullptr) {
+            return parent->isPartialIdxDeclared(view, rank);
+        } else {
+            return false;
+        }
+    }
+
+    // Get the name (symbol) of the partial index of 'view' that covers the axes up to 'rank'
+    template<typename T>
+    void getPartialIdxName(const bh_view &view, int rank, T &out) const {
+        out << "po" << symbols.offsetStridesID(view) << "_" << rank;
+    }
+
+    // Write the variable declaration of the partial index of 'view' that covers the axes up to 'rank'
+    void writePartialIdxDeclaration(const bh_view &view, int rank, const std::string &type_str,
+                                    std::stringstream &out);
+
     // Get the name (symbol) of the 'base'
     template<typename T>
     void getIdxName(const bh_view &view, T &out) const {
@@ -80,20 +80,35 @@ class Statistics {
     uint64_t threading_below_threshold = 0;
     uint64_t fuser_cache_lookups       = 0;
     uint64_t fuser_cache_misses        = 0;
+    uint64_t fuser_cache_disk_hits     = 0;
     uint64_t codegen_cache_lookups     = 0;
     uint64_t codegen_cache_misses      = 0;
+    uint64_t codegen_cache_disk_hits   = 0;
     uint64_t kernel_cache_lookups      = 0;
     uint64_t kernel_cache_misses       = 0;
     uint64_t num_instrs_into_fuser     = 0;
     uint64_t num_blocks_out_of_fuser   = 0;
     uint64_t malloc_cache_lookups      = 0;
     uint64_t malloc_cache_misses       = 0;
+    uint64_t num_interpreted_kernels   = 0;
+    uint64_t num_batch_compilations    = 0;
+    uint64_t num_tier_ups              = 0; // Kernels recompiled with the strides and sizes as literals
+    uint64_t memory_plan_arrays        = 0;
+    uint64_t memory_plan_array_bytes   = 0; // The largest flush: the bytes of the arrays placed by the memory plan
+    uint64_t memory_plan_arena_bytes   = 0; // The largest flush: the bytes of the arena of the memory plan
+    uint64_t page_faults_minor         = 0;
+    uint64_t page_faults_major         = 0;
+    int64_t  dtlb_misses               = -1; // Data TLB load misses or -1 when not available
+    uint64_t spilled_bytes             = 0;
+    uint64_t spill_restored_bytes      = 0;
     std::chrono::duration<double> time_total_execution{0};
     std::chrono::duration<double> time_pre_fusion{0};
     std::chrono::duration<double> time_fusion{0};
     std::chrono::duration<double> time_codegen{0};
     std::chrono::duration<double> time_compile{0};
     std::chrono::duration<double> time_exec{0};
+    std::chrono::duration<double> time_interpret{0};
+    std::chrono::duration<double> time_async_compile{0}; // Compile time hidden in the background
     std::chrono::duration<double> time_offload{0};
     std::chrono::duration<double> time_copy2dev{0};
     std::chrono::duration<double> time_copy2host{0};
@@ -102,6 +117,12 @@ class Statistics {
     // key: kernel source filename, value: kernel statistics
     std::map<std::string, KernelStats> time_per_kernel;
 
+    // key: compiler backend, value: compile statistics
+    std::map<std::string, KernelStats> time_compile_per_backend;
+
+    // key: NUMA placement (e.g. 'interleave' or 'node0'), value: max memory usage in bytes
+    std::map<std::string, uint64_t> max_memory_usage_per_numa_placement;
+
     std::chrono::duration<double> wallclock{0};
     std::chrono::time_point<std::chrono::steady_clock> time_started{std::chrono::steady_clock::now()};
 
@@ -129,13 +150,28 @@ class Statistics {
 
             out << BLU << "[" << backend_name << "] Profiling: \n" << RST;
             out << "Fuse cache hits:                 " << GRN << fuseCacheHits()                     << "\n" << RST;
+            out << "  from disk:                     " << GRN << fuser_cache_disk_hits               << "\n" << RST;
             out << "Codegen cache hits:              " << GRN << codegenCacheHits()                  << "\n" << RST;
+            out << "  from disk:                     " << GRN << codegen_cache_disk_hits             << "\n" << RST;
             out << "Compilation cache hits:          " << GRN << kernelCacheHits()                   << "\n" << RST;
+            out << "Batch compilations:              " << GRN << num_batch_compilations              << "\n" << RST;
+            out << "Tier-ups:                        " << GRN << num_tier_ups                        << "\n" << RST;
             out << "Array contractions:              " << GRN << arrayContractions()                 << "\n" << RST;
             out << "Outer-fusion ratio:              " << GRN << outerFusionRatio()                  << "\n" << RST;
             out << "Malloc cache hits:               " << GRN << MallocCacheHits()                   << "\n" << RST;
             out << "\n";
             out << "Max memory usage:                " << GRN << memoryUsage() << " MB"              << "\n" << RST;
+            for (const auto &placement: max_memory_usage_per_numa_placement) {
+                out << "  " << std::left << std::setw(30) << (placement.first + ":") << GRN
+                    << placement.second / 1024 / 1024 << " MB"                                       << "\n" << RST;
+            }
+            out << "Memory plan (arena/arrays):      " << GRN << memoryPlan()
+                                                      << " (" << memory_plan_arrays << " arrays)"    << "\n" << RST;
+            out << "Page faults (minor/major):       " << GRN << page_faults_minor << "/"
+                                                      << page_faults_major                            << "\n" << RST;
+            out << "Data TLB misses:                 " << GRN << dtlbMisses()                        << "\n" << RST;
+            out << "Spilled/restored:                " << GRN << spilled_bytes / 1024 / 1024 << "/"
+                                                      << spill_restored_bytes / 1024 / 1024 << " MB" << "\n" << RST;
             out << "Syncs to NumPy:                  " << GRN << num_syncs                           << "\n" << RST;
             out << "Total Work:                      " << GRN << totalwork << " operations"          << "\n" << RST;
             out << "Throughput:                      " << GRN << throughput() << "ops"               << "\n" << RST;
@@ -147,12 +183,20 @@ class Statistics {
             out << "  Fusion:                        " << YEL << time_fusion.count() << "s"          << "\n" << RST;
             out << "  Codegen:                       " << YEL << time_codegen.count() << "s"         << "\n" << RST;
             out << "  Compilation:                   " << YEL << time_compile.count() << "s"         << "\n" << RST;
+            for (const auto &backend: time_compile_per_backend) {
+                out << "    " << std::left << std::setw(28) << (backend.first + ":") << YEL
+                    << backend.second.total_time.count() << "s (" << backend.second.num_calls << " compilations, "
+                    << backend.second.total_time.count() / backend.second.num_calls << "s avg)" << "\n" << RST;
+            }
             out << "  Exec:                          " << YEL << time_exec.count() << "s"            << "\n" << RST;
+            out << "  Interpreter:                   " << YEL << time_interpret.count() << "s"
+                                                      << " (" << num_interpreted_kernels << " kernels)" << "\n" << RST;
             out << "  Copy2dev:                      " << YEL << time_copy2dev.count() << "s"        << "\n" << RST;
             out << "  Copy2host:                     " << YEL << time_copy2host.count() << "s"       << "\n" << RST;
             out << "  Offload:                       " << YEL << time_offload.count() << "s"         << "\n" << RST;
             out << "  Other:                         " << YEL << timeOther() << "s"                  << "\n" << RST;
             out << "Ext-method:                      " << YEL << time_ext_method.count() << "s"      << "\n" << RST;
+            out << "Background compilation:          " << YEL << time_async_compile.count() << "s"   << "\n" << RST;
             out << "\n";
             out << BOLD << RED << "Unaccounted for (wall - total):  " << unaccounted() << "s\n" << RST;
 
@@ -219,11 +263,29 @@ class Statistics {
             file << "----"                                                           << "\n";
             file << backend_name << ":"                                              << "\n";
             file << "  fuse_cache_hits: "       << fuseCacheHits()                   << "\n";
+            file << "  fuse_cache_disk_hits: "  << fuser_cache_disk_hits             << "\n";
             file << "  codegen_cache_hits: "    << codegenCacheHits()                << "\n";
+            file << "  codegen_cache_disk_hits: " << codegen_cache_disk_hits         << "\n";
             file << "  kernel_cache_hits: "     << kernelCacheHits()                 << "\n";
+            file << "  batch_compilations: "    << num_batch_compilations            << "\n";
+            file << "  tier_ups: "              << num_tier_ups                      << "\n";
             file << "  array_contractions: "    << arrayContractions()               << "\n";
             file << "  outer_fusion_ratio: "    << outerFusionRatio()                << "\n";
             file << "  memory_usage: "          << memoryUsage()                     << "\n"; // mb
+            if (not max_memory_usage_per_numa_placement.empty()) {
+              file << "  memory_usage_per_numa_placement: "                          << "\n";
+              for (auto const& x : max_memory_usage_per_numa_placement) {
+                file << "    " << x.first << ": " << x.second / 1024 / 1024          << "\n"; // mb
+              }
+            }
+            file << "  memory_plan_arrays: "    << memory_plan_arrays                << "\n";
+            file << "  memory_plan_array_bytes: " << memory_plan_array_bytes         << "\n";
+            file << "  memory_plan_arena_bytes: " << memory_plan_arena_bytes         << "\n";
+            file << "  page_faults_minor: "     << page_faults_minor                 << "\n";
+            file << "  page_faults_major: "     << page_faults_major                 << "\n";
+            file << "  dtlb_misses: "           << dtlb_misses                       << "\n"; // -1 if not available
+            file << "  spilled_bytes: "         << spilled_bytes                     << "\n";
+            file << "  spill_restored_bytes: "  << spill_restored_bytes              << "\n";
             file << "  syncs: "                 << num_syncs                         << "\n";
             file << "  total_work: "            << totalwork                         << "\n"; // ops
             file << "  throughput: "            << throughput()                      << "\n"; // ops
@@ -234,6 +296,19 @@ class Statistics {
             file << "    pre_fusion: "          << time_pre_fusion.count()           << "\n"; // s
             file << "    fusion: "              << time_fusion.count()               << "\n"; // s
             file << "    compile: "             << time_compile.count()              << "\n"; // s
+            if (not time_compile_per_backend.empty()) {
+              file << "    compile_per_backend: "                                    << "\n";
+              for (auto const& x : time_compile_per_backend) {
+                file << "      " << x.first << ": "                                  << "\n";
+                file << "        num_calls: "  << x.second.num_calls                 << "\n";
+                file << "        total_time: " << x.second.total_time.count()        << "\n"; // s
+                file << "        max_time: "   << x.second.max_time.count()          << "\n"; // s
+                file << "        min_time: "   << x.second.min_time.count()          << "\n"; // s
+              }
+            }
+            file << "    async_compile: "       << time_async_compile.count()        << "\n"; // s
+            file << "    interpret: "           << time_interpret.count()            << "\n"; // s
+            file << "    interpreted_kernels: " << num_interpreted_kernels           << "\n";
             file << "    exec: "                                                     << "\n";
             file << "      total: "             << time_exec.count()                 << "\n"; // s
             if (verbose) {
@@ -300,6 +375,14 @@ class Statistics {
         return pprint_ratio(malloc_cache_lookups - malloc_cache_misses, malloc_cache_lookups);
     }
 
+    std::string memoryPlan() {
+        return pprint_ratio(memory_plan_arena_bytes, memory_plan_array_bytes);
+    }
+
+    std::string dtlbMisses() {
+        return dtlb_misses < 0 ? "n/a" : std::to_string(dtlb_misses);
+    }
+
     double memoryUsage() {
         return max_memory_usage / 1024 / 1024;
     }
@@ -314,7 +397,7 @@ class Statistics {
 
     double timeOther() {
         return (time_total_execution - time_pre_fusion - time_fusion - time_codegen - time_compile - time_exec
-                - time_copy2dev - time_copy2host - time_offload).count();
+                - time_interpret - time_copy2dev - time_copy2host - time_offload).count();
     }
 
     double unaccounted() {
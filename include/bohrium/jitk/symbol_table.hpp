@@ -126,6 +126,8 @@ private:
     std::set<InstrPtr, Constant_less> _constant_set; // Set of instructions to a constant ID (Order by `origin_id`)
     std::set<bh_base*> _array_always; // Set of base arrays that should always be arrays
     std::vector<bh_base*> _params; // Vector of non-temporary arrays, which are the in-/out-puts of the JIT kernel
+    std::map<const LoopB*, size_t> _loop_size_map; // Mapping a loop to the ID of its size
+    std::vector<int64_t> _loop_sizes; // The size of each loop ordered by ID
     bool _useRandom; // Flag: is any instructions using random?
 
 public:
@@ -137,8 +139,13 @@ public:
     const bool index_as_var;
     // Should we use constants as variables?
     const bool const_as_var;
+    // Should we use the sizes of the loops as variables?
+    const bool shape_as_var;
+    // Should we hoist the partial index of each loop out of the loops below it?
+    const bool index_strength_reduce;
 
-    SymbolTable(const LoopB &kernel, bool use_volatile, bool strides_as_var, bool index_as_var, bool const_as_var);
+    SymbolTable(const LoopB &kernel, bool use_volatile, bool strides_as_var, bool index_as_var, bool const_as_var,
+                bool shape_as_var = false, bool index_strength_reduce = false);
 
     // Get the ID of 'base', throws exception if 'base' doesn't exist
     size_t baseID(const bh_base *base) const {
@@ -170,6 +177,24 @@ public:
     const std::vector<const bh_view*> &offsetStrideViews() const {
         return _offset_stride_views;
     }
+    // Get the ID of the size of 'loop', throws exception if 'loop' doesn't exist or `shape_as_var` is disabled
+    size_t loopSizeID(const LoopB &loop) const {
+        return _loop_size_map.at(&loop);
+    }
+    // Get the sizes of all loops ordered by ID (empty when `shape_as_var` is disabled)
+    const std::vector<int64_t> &loopSizes() const {
+        return _loop_sizes;
+    }
+    // Return the size of 'loop' as it should be written in the source code, which is a variable or a literal
+    std::string loopSize(const LoopB &loop) const {
+        std::stringstream ss;
+        if (shape_as_var) {
+            ss << "ls" << loopSizeID(loop);
+        } else {
+            ss << loop.size;
+        }
+        return ss.str();
+    }
     // Get the set of constants
     const std::set<InstrPtr, Constant_less> &constIDs() const {
         return _constant_set;
@@ -0,0 +1,104 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <exception>
+#include <condition_variable>
+
+namespace bohrium {
+namespace jitk {
+
+/** A work-stealing thread pool that executes a DAG of tasks.
+ *  Each worker has its own deque of ready tasks: the worker pops from the back (thus a task that becomes ready is
+ *  likely to run on the worker that produced its input) and idle workers steal from the front of other deques.
+ */
+class TaskScheduler {
+    struct Worker {
+        std::deque<size_t> queue;
+        std::mutex mutex;
+    };
+    std::vector<std::unique_ptr<Worker> > _workers;
+    std::vector<std::thread> _threads;
+
+    // Protects `_num_queued`, `_num_running`, `_remaining`, `_stop`, and `_error`
+    std::mutex _mutex;
+    std::condition_variable _cv_work;
+    std::condition_variable _cv_done;
+    size_t _num_queued = 0;
+    size_t _num_running = 0;
+    size_t _remaining = 0;
+    bool _stop = false;
+    std::exception_ptr _error;
+
+    // The DAG of the current `run()`
+    const std::vector<std::function<void()> > *_tasks = nullptr;
+    std::vector<std::vector<size_t> > _successors;
+    std::unique_ptr<std::atomic<size_t>[]> _num_predecessors;
+
+    // Push the ready task `task` to the deque of worker `worker_id`
+    void push(size_t worker_id, size_t task);
+
+    // Pop a ready task for worker `worker_id` (stealing if its own deque is empty). Returns false if none is ready.
+    bool pop(size_t worker_id, size_t &task);
+
+    // Execute `task` and push the successors that become ready
+    void execute(size_t worker_id, size_t task);
+
+    // The loop of each worker thread
+    void workerLoop(size_t worker_id);
+
+public:
+    /** Constructor that starts the worker threads
+     *
+     * @param num_threads The number of worker threads
+     */
+    explicit TaskScheduler(size_t num_threads);
+
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    /** Execute `tasks` concurrently and wait for all of them to finish
+     *
+     * @param tasks        The tasks to execute
+     * @param predecessors `predecessors[i]` is the indexes of the tasks that must finish before `tasks[i]` starts
+     * NB: if a task throws, its successors are skipped and the first exception is re-thrown
+     */
+    void run(const std::vector<std::function<void()> > &tasks, const std::vector<std::vector<size_t> > &predecessors);
+
+    // Return the number of worker threads
+    size_t numThreads() const {
+        return _threads.size();
+    }
+
+    // Return the number of tasks that are running or ready to run, which is at most the number of worker threads
+    size_t numReadyTasks();
+};
+
+} // jitk
+} // bohrium
@@ -38,5 +38,16 @@ void split_for_threading(std::vector<Block> &block_list, uint64_t min_threading=
 // Collapses redundant axes within the 'block_list'
 void collapse_redundant_axes(std::vector<Block> &block_list);
 
+// Reorders the loops of the loop nests in 'block_list' such that the axes with the smallest strides become the
+// innermost loops, e.g. transposed or column-major views. The outermost loop is kept if the new one would sweep or
+// have less than 'min_threading' iterations.
+void interchange_loops(std::vector<Block> &block_list, uint64_t min_threading=1000);
+
+// Tiles the two innermost axes of the element-wise loop nests in 'block_list' that read an array across cache lines
+// along the innermost axis, e.g. a transposed view. The tiles fit in `cache_size` bytes (0 detects the L1 cache) and
+// are grouped in tiles that fit in `l2_size` bytes (0 detects the L2 cache). The remainders of axes the tiles
+// don't divide become separate loop nests.
+void tile_for_cache(std::vector<Block> &block_list, uint64_t cache_size = 0, uint64_t l2_size = 0);
+
 } // jitk
 } // bohrium
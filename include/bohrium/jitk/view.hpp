@@ -27,6 +27,11 @@ If not, see <http://www.gnu.org/licenses/>.
 namespace bohrium {
 namespace jitk {
 
+// Return the view whose array index is the flat index of 'view', i.e. a contiguous view of the same shape that
+// starts at zero. BH_RANGE writes this index, which is the same as the array index of 'view' only when 'view' is
+// contiguous and starts at zero.
+bh_view range_index_view(const bh_view &view);
+
 // Write the array index, e.g. (2+i0*1+i1*10), but ignore the loop-variant of 'hidden_axis' if it isn't 'BH_MAXDIM'
 // Use 'axis_offset' to offset an axis, which is needed for accumulate
 // Set 'ignore_declared_indexes' to not use indexes variables
@@ -34,6 +39,10 @@ void write_array_index(const Scope &scope, const bh_view &view, std::stringstrea
                        bool ignore_declared_indexes = false, int hidden_axis = BH_MAXDIM,
                        const std::pair<int, int> axis_offset = std::make_pair(BH_MAXDIM, 0));
 
+// Write the index of the axes up to 'rank' (inclusive) of 'view', e.g. (2+i0*1), which is the partial index of
+// 'view' hoisted out of the loops below 'rank' when `index_strength_reduce` is enabled
+void write_array_partial_index(const Scope &scope, const bh_view &view, int rank, std::stringstream &out);
+
 // Write the array subscription, e.g. A[2+i0*1+i1*10], but ignore the loop-variant of 'hidden_axis' if it isn't 'BH_MAXDIM'
 // Set 'ignore_declared_indexes' to not use indexes variables
 void write_array_subscription(const Scope &scope, const bh_view &view, std::stringstream &out,
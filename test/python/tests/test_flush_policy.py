@@ -0,0 +1,62 @@
+"""
+Test programs that span many flushes, which the flush policy of the bridge decides. Enable the adaptive threshold
+by running the tests with `BH_BRIDGE_ADAPTIVE_FLUSH=true` and use a small `BH_BRIDGE_FLUSH_THRESHOLD_MIN`, such as
+10, to let it shrink. Enable the memory limit with a small `BH_BRIDGE_FLUSH_TEMP_MEMORY`, such as 1. Run them with
+`BH_BRIDGE_ASYNC_FLUSH=true` as well, which executes flushes on a background thread while the next flush is recorded.
+"""
+import util
+
+
+class test_many_flushes:
+    """ Test loops of many instructions, which the flush threshold splits into several flushes"""
+
+    def init(self):
+        for niters in [10, 500, 3000]:
+            yield niters
+
+    def test_iterate(self, niters):
+        cmd = """
+a = M.arange(100, dtype=np.float64)
+res = M.zeros_like(a)
+for i in range(%d):
+    res += a * 0.5 - res * 0.01
+""" % niters
+        return cmd
+
+    def test_temporaries(self, niters):
+        cmd = """
+a = M.arange(100, dtype=np.float64)
+res = M.zeros_like(a)
+for i in range(%d):
+    t = M.ones_like(a) * i
+    res = res + t[::-1] - a
+""" % niters
+        return cmd
+
+    @util.add_bh107_cmd
+    def test_reduce(self, niters):
+        cmd = """
+R = bh.random.RandomState(42)
+a = R.random_of_dtype(shape=(50, 20), dtype=np.float64, bohrium=BH)
+res = M.zeros(20)
+for i in range(%d):
+    res += M.add.reduce(a * (i %% 7), axis=0)
+""" % niters
+        return cmd
+
+
+class test_temp_memory:
+    """ Test flushes that create large temporary arrays, which the memory limit may flush early"""
+
+    def init(self):
+        for size in [1000, 1000000]:
+            yield size
+
+    def test_create(self, size):
+        cmd = """
+res = M.zeros(%d)
+for i in range(20):
+    t = M.arange(%d, dtype=np.float64) + i
+    res += t
+""" % (size, size)
+        return cmd
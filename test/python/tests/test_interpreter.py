@@ -0,0 +1,94 @@
+"""
+Test the kernel interpreter of the OpenMP backend, which executes kernels while they are being compiled.
+Enable it by running the tests with `BH_OPENMP_ASYNC_COMPILE=true`; otherwise these are regular JIT tests.
+"""
+import util
+
+
+class test_elementwise:
+    """ Test the element-wise opcodes of the interpreter on all the types it supports"""
+
+    def init(self):
+        for op in ["add", "subtract", "multiply", "maximum", "minimum", "greater", "greater_equal", "less",
+                   "less_equal", "equal", "not_equal", "logical_and", "logical_or", "logical_xor"]:
+            for dtype in util.TYPES.NORMAL:
+                yield (op, dtype)
+
+    @util.add_bh107_cmd
+    def test_binary(self, arg):
+        (op, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); " \
+              "a = R.random_of_dtype(shape=(10, 20), dtype=%s, bohrium=BH); " \
+              "b = R.random_of_dtype(shape=(10, 20), dtype=%s, bohrium=BH); " % (dtype, dtype)
+        cmd += "res = M.%s(a, b)" % op
+        return cmd
+
+
+class test_reduce:
+    """ Test the reductions of the interpreter"""
+
+    def init(self):
+        for op in ["add", "multiply", "maximum", "minimum"]:
+            for dtype in util.TYPES.NORMAL:
+                for axis in range(2):
+                    yield (op, dtype, axis)
+
+    @util.add_bh107_cmd
+    def test_reduce(self, arg):
+        (op, dtype, axis) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=(10, 20), dtype=%s, bohrium=BH); " % dtype
+        cmd += "res = M.%s.reduce(a, axis=%d)" % (op, axis)
+        return cmd
+
+
+class test_accumulate:
+    """ Test the accumulations of the interpreter"""
+
+    def init(self):
+        for op in ["add", "multiply"]:
+            for dtype in util.TYPES.NORMAL:
+                for axis in range(2):
+                    yield (op, dtype, axis)
+
+    @util.add_bh107_cmd
+    def test_accumulate(self, arg):
+        (op, dtype, axis) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=(10, 20), dtype=%s, bohrium=BH); " % dtype
+        cmd += "res = M.%s.accumulate(a, axis=%d)" % (op, axis)
+        return cmd
+
+
+class test_uint64:
+    """ Test that the interpreter uses unsigned arithmetic for uint64 values above the int64 range"""
+
+    def init(self):
+        cmd = "a = M.arange(10, dtype=np.uint64) + np.uint64(2**63); "
+        yield cmd + "res = M.maximum(a, np.uint64(5))"
+        yield cmd + "res = M.minimum(a, np.uint64(5))"
+        yield cmd + "res = a > np.uint64(2**63 + 4)"
+        yield cmd + "res = a <= np.uint64(2**63 + 4)"
+        yield cmd + "res = M.maximum.reduce(a)"
+        yield cmd + "res = M.minimum.reduce(a[::-1])"
+        yield cmd + "res = a - np.uint64(2**63 + 1)"
+
+    def test_uint64(self, cmd):
+        return cmd
+
+
+class test_range:
+    """ Test that the interpreter writes the flat index, not the memory offset, when the range output is a view"""
+
+    def init(self):
+        yield ("(30,)", "[3::2]", "(14,)")
+        yield ("(6, 8)", "[1:, ::2]", "(5, 4)")
+        yield ("(6, 8)", "[::-1, 2:7]", "(6, 5)")
+
+    def test_range(self, arg):
+        (shape, view, view_shape) = arg
+        cmd_np = "res = np.zeros(%s, dtype=np.uint64); " % shape
+        cmd_np += "res%s = np.arange(np.prod(%s), dtype=np.uint64).reshape(%s)" % (view, view_shape, view_shape)
+        # NB: the Python bridge only ranges into new arrays thus we call the range opcode directly
+        cmd_bh = "from bohrium import _bh; from bohrium_api import _info; "
+        cmd_bh += "res = bh.zeros(%s, dtype=np.uint64); " % shape
+        cmd_bh += "_bh.ufunc(_info.op['range']['id'], (res%s,))" % view
+        return cmd_np, cmd_bh
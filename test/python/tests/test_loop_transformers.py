@@ -0,0 +1,77 @@
+"""
+Test the loop nest transformers of the OpenMP backend. Enable them by running the tests with
+`BH_OPENMP_FUSER_LIST="greedy, interchange_loops, collapse_redundant_axes, tile_for_cache"` and use a small
+`BH_OPENMP_TILE_CACHE_SIZE` and `BH_OPENMP_TILE_L2_CACHE_SIZE`, such as 4096 and 32768, to tile the small arrays
+at both cache levels. Without the transformers these are regular tests.
+"""
+import util
+
+
+class test_tiling:
+    """ Test element-wise loop nests that read transposed views, which are tiled including the remainders of axes
+        the tiles don't divide"""
+
+    def init(self):
+        for shape in [(64, 128), (100, 37), (301, 257), (1003, 2001), (5, 7, 300)]:
+            for dtype in ["np.float64", "np.float32", "np.int16"]:
+                yield (shape, dtype)
+
+    @util.add_bh107_cmd
+    def test_transpose(self, arg):
+        (shape, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " \
+              % (shape, dtype)
+        cmd += "res = a.T + 1"
+        return cmd
+
+    @util.add_bh107_cmd
+    def test_transpose_temp(self, arg):
+        (shape, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); " \
+              "a = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " \
+              "b = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " % (shape, dtype, shape[::-1], dtype)
+        # NB: the product is a temporary array, which every tiled loop nest contracts
+        cmd += "res = a.T * b + b"
+        return cmd
+
+    @util.add_bh107_cmd
+    def test_transpose_view(self, arg):
+        (shape, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " \
+              % (shape, dtype)
+        cmd += "res = a[::-1].T * 2"
+        return cmd
+
+
+class test_interchange:
+    """ Test loop nests over column-major and transposed views, which are reordered such that the axes of the
+        smallest strides become the innermost loops"""
+
+    def init(self):
+        for shape in [(3, 1000), (200, 300), (4, 50, 60)]:
+            for dtype in ["np.float64", "np.int32"]:
+                yield (shape, dtype)
+
+    @util.add_bh107_cmd
+    def test_column_major(self, arg):
+        (shape, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " \
+              % (shape[::-1], dtype)
+        cmd += "b = a.T; res = b * b - 1"
+        return cmd
+
+    @util.add_bh107_cmd
+    def test_reduce(self, arg):
+        (shape, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " \
+              % (shape[::-1], dtype)
+        cmd += "res = M.add.reduce(a.T + 1, axis=0)"
+        return cmd
+
+    @util.add_bh107_cmd
+    def test_reduce_inner(self, arg):
+        (shape, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " \
+              % (shape[::-1], dtype)
+        cmd += "res = M.maximum.reduce(a.T * 2, axis=-1)"
+        return cmd
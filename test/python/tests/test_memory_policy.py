@@ -0,0 +1,45 @@
+"""
+Test programs under the memory policies of the OpenMP backend that touch new arrays with a kernel, i.e.
+`prefault = parallel` and `numa_policy = first_touch`. Each program runs in its own process since the policies
+are read when the backend starts.
+"""
+import util
+
+# The program prints a sum over arrays that are allocated, and thus touched, by the backend
+program = """
+import bohrium as np
+a = np.arange(%d, dtype=np.float64)
+b = a * 2 + 1
+c = np.sqrt(b) + a[::-1]
+print(repr(float(np.add.reduce(c))))
+"""
+
+# NB: the names of the environment variables are upper-cased here since the test runner replaces "M" and "BH"
+run_cmd = """
+import os, subprocess, sys
+env = dict(os.environ)
+env.update((name.upper(), value) for name, value in %r)
+res = float(subprocess.check_output([sys.executable, "-c", %r], env=env))
+"""
+
+numpy_cmd = """
+a = np.arange(%d, dtype=np.float64)
+b = a * 2 + 1
+c = np.sqrt(b) + a[::-1]
+res = float(np.add.reduce(c))
+"""
+
+
+class test_memory_policy:
+    """ Test that programs run, and give the same result as NumPy, when the backend touches new arrays"""
+
+    def init(self):
+        for policy in [[("bh_openmp_prefault", "parallel"), ("bh_openmp_prefault_threshold", "0")],
+                       [("bh_openmp_numa_policy", "first_touch"), ("bh_openmp_numa_threshold", "0")]]:
+            # NB: the large arrays span many pages, which are touched by several threads
+            for size in [10, 1000000]:
+                yield (policy, size)
+
+    def test_program(self, arg):
+        (policy, size) = arg
+        return numpy_cmd % size, run_cmd % (policy, program % size)
@@ -0,0 +1,124 @@
+"""
+Test the parallel code paths of the OpenMP backend: array section reductions, parallel prefix scans, and
+explicit vector loops. The first two require `BH_OPENMP_COMPILER_OPENMP=true` and the vector loops require
+`BH_OPENMP_COMPILER_SIMD=true`. Run the tests again with `BH_OPENMP_STRIDES_AS_VAR=false` and with
+`BH_OPENMP_SHAPE_AS_VAR=true` to cover the other kernel reuse modes.
+"""
+import util
+
+
+class test_section_reduce:
+    """ Test reductions to small arrays, which use OpenMP array section reductions"""
+
+    def init(self):
+        # NB: the last shapes have an output larger than the array section limit thus they use atomic guards
+        for shape in [(1000, 3), (200, 64), (50, 4000), (20, 5000)]:
+            for op in ["add", "multiply", "maximum", "minimum"]:
+                for dtype in ["np.float64", "np.int64"]:
+                    yield (shape, op, dtype)
+
+    @util.add_bh107_cmd
+    def test_reduce(self, arg):
+        (shape, op, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " % (shape, dtype)
+        cmd += "res = M.%s.reduce(a, axis=0)" % op
+        return cmd
+
+    @util.add_bh107_cmd
+    def test_reduce_view(self, arg):
+        (shape, op, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " % (shape, dtype)
+        cmd += "res = M.%s.reduce(a[::2, ::-1], axis=0)" % op
+        return cmd
+
+
+class test_section_reduce_reuse:
+    """ Test that a kernel generated for a small output isn't reused for an output beyond the array section limit"""
+
+    def init(self):
+        cmd = "R = bh.random.RandomState(42); res = 0; "
+        for n in [10, 3000, 5000, 10]:
+            cmd += "a = R.random_of_dtype(shape=(100, %d), dtype=np.float64, bohrium=BH); " % n
+            cmd += "res = res + M.add.reduce(a, axis=0)[:10]; "
+        yield cmd
+
+    @util.add_bh107_cmd
+    def test_reuse(self, cmd):
+        return cmd
+
+
+class test_scan:
+    """ Test one-dimensional accumulates, which use a parallel prefix scan"""
+
+    def init(self):
+        for size in [1, 7, 1000, 100003]:
+            for op in ["add", "multiply"]:
+                for dtype in ["np.float64", "np.int64", "np.int32"]:
+                    yield (size, op, dtype)
+
+    @util.add_bh107_cmd
+    def test_accumulate(self, arg):
+        (size, op, dtype) = arg
+        # NB: the values of the products are kept close to one, thus they stay within the range of the types
+        if op == "multiply" and "float" in dtype:
+            cmd = "R = bh.random.RandomState(42); " \
+                  "a = R.random_of_dtype(shape=(%d,), dtype=%s, bohrium=BH) * 0.001 + 1; " % (size, dtype)
+        elif op == "multiply":
+            cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=(%d,), dtype=%s, bohrium=BH); " \
+                  "a = a %% 2 * 2 - 1; " % (size, dtype)
+        else:
+            cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=(%d,), dtype=%s, bohrium=BH); " \
+                  % (size, dtype)
+        cmd += "res = M.%s.accumulate(a)" % op
+        return cmd
+
+
+class test_scan_view:
+    """ Test parallel prefix scans of strided views"""
+
+    def init(self):
+        for size in [7, 100003]:
+            for dtype in ["np.float64", "np.int64"]:
+                yield (size, dtype)
+
+    @util.add_bh107_cmd
+    def test_accumulate(self, arg):
+        (size, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=(%d,), dtype=%s, bohrium=BH); " \
+              % (size, dtype)
+        cmd += "res = M.add.accumulate(a[::-3])"
+        return cmd
+
+
+class test_vector_loop:
+    """ Test contiguous innermost loops, which are written as explicit vector loops followed by a scalar remainder"""
+
+    def init(self):
+        for size in [1, 3, 17, 64, 1001]:
+            for dtype in util.TYPES.NORMAL:
+                yield (size, dtype)
+
+    @util.add_bh107_cmd
+    def test_elementwise(self, arg):
+        (size, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); " \
+              "a = R.random_of_dtype(shape=(3, %d), dtype=%s, bohrium=BH); " \
+              "b = R.random_of_dtype(shape=(3, %d), dtype=%s, bohrium=BH); " % (size, dtype, size, dtype)
+        cmd += "res = M.maximum(a + b * a, b)"
+        return cmd
+
+    @util.add_bh107_cmd
+    def test_offset(self, arg):
+        (size, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=(%d,), dtype=%s, bohrium=BH); " \
+              % (size + 1, dtype)
+        cmd += "res = a[1:] - a[:-1]"
+        return cmd
+
+    @util.add_bh107_cmd
+    def test_reduce(self, arg):
+        (size, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=(3, %d), dtype=%s, bohrium=BH); " \
+              % (size, dtype)
+        cmd += "res = M.add.reduce(a, axis=1)"
+        return cmd
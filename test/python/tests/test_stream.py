@@ -0,0 +1,100 @@
+"""
+Test the stream filter, which executes a flush in chunks of rows. Enable it by running the tests with
+`BH_STACK=stream`; set `BH_STREAM_CHUNK_SIZE` to a small value such as 1024 to split even small arrays into
+many chunks. Without the filter these are regular tests.
+"""
+import util
+
+
+class test_elementwise:
+    """ Test chains of element-wise operations, which are split into chunks of rows"""
+
+    def init(self):
+        # NB: the row counts are not divisible by the number of rows in a chunk
+        for shape in [(1,), (1001,), (37, 50), (1001, 3), (7, 9, 11)]:
+            for dtype in ["np.float64", "np.int32"]:
+                yield (shape, dtype)
+
+    @util.add_bh107_cmd
+    def test_pipeline(self, arg):
+        (shape, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); " \
+              "a = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " \
+              "b = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " % (shape, dtype, shape, dtype)
+        cmd += "t = a + b; t = t * a; t = M.maximum(t, b); res = t - a"
+        return cmd
+
+    @util.add_bh107_cmd
+    def test_inplace(self, arg):
+        (shape, dtype) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=%s, dtype=%s, bohrium=BH); " % (shape, dtype)
+        cmd += "res = a.copy(); res += a; res *= a"
+        return cmd
+
+
+class test_reduce:
+    """ Test reductions, where a reduction along the outermost axis is combined from partial results"""
+
+    def init(self):
+        for shape in [(1001,), (1001, 3), (37, 50)]:
+            for op in ["add", "multiply", "maximum", "minimum"]:
+                for axis in range(len(shape)):
+                    yield (shape, op, axis)
+
+    @util.add_bh107_cmd
+    def test_reduce(self, arg):
+        (shape, op, axis) = arg
+        # NB: the values of the products are kept close to one, thus they stay finite
+        cmd = "R = bh.random.RandomState(42); " \
+              "a = R.random_of_dtype(shape=%s, dtype=np.float64, bohrium=BH) * 0.001 + 1; " % (shape,)
+        cmd += "res = M.%s.reduce(a * a, axis=%d)" % (op, axis)
+        return cmd
+
+    @util.add_bh107_cmd
+    def test_reduce_int(self, arg):
+        (shape, op, axis) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=%s, dtype=np.int64, bohrium=BH); " \
+              % (shape,)
+        if op == "multiply":
+            cmd += "a = a % 2 * 2 - 1; "
+        cmd += "res = M.%s.reduce(a + 1, axis=%d)" % (op, axis)
+        return cmd
+
+
+class test_accumulate:
+    """ Test accumulations, which can only be split when they are not along the outermost axis"""
+
+    def init(self):
+        for shape in [(1001,), (1001, 3), (37, 50)]:
+            for axis in range(len(shape)):
+                yield (shape, axis)
+
+    @util.add_bh107_cmd
+    def test_accumulate(self, arg):
+        (shape, axis) = arg
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=%s, dtype=np.float64, bohrium=BH); " \
+              % (shape,)
+        cmd += "res = M.add.accumulate(a + 1, axis=%d)" % axis
+        return cmd
+
+
+class test_views:
+    """ Test flushes where views of the same array access different rows, which cannot be split"""
+
+    def init(self):
+        for size in [10, 1001]:
+            yield size
+
+    @util.add_bh107_cmd
+    def test_shift(self, size):
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=(%d,), dtype=np.float64, bohrium=BH); " \
+              % size
+        cmd += "a[1:] = a[:-1] + 1; res = a"
+        return cmd
+
+    @util.add_bh107_cmd
+    def test_reverse(self, size):
+        cmd = "R = bh.random.RandomState(42); a = R.random_of_dtype(shape=(%d, 3), dtype=np.float64, bohrium=BH); " \
+              % size
+        cmd += "res = a[::-1] * 2 + a"
+        return cmd
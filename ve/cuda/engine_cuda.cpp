@@ -128,7 +128,7 @@ EngineCUDA::~EngineCUDA() {
     }
 
     if (cache_file_max != -1 and use_cache) {
-        util::remove_old_files(cache_bin_dir, cache_file_max);
+        util::remove_old_files(cache_bin_dir, cache_file_max, ".cubin");
     }
 
     // We empty the malloc cache before detaching the context
@@ -83,6 +83,9 @@ class Impl : public ComponentVE {
             engine.useCurrentContext();
         } else if (msg == "info") {
             ss << engine.info();
+        } else if (msg == "fuse_cache_stat") {
+            // NB: the bridge sums the "<lookups> <misses>" pairs of all engines in the stack
+            ss << stat.fuser_cache_lookups << " " << stat.fuser_cache_misses << " ";
         }
         return ss.str() + child.message(msg);
     }
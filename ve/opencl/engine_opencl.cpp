@@ -174,7 +174,7 @@ EngineOpenCL::~EngineOpenCL() {
     }
 
     if (cache_file_max != -1 and use_cache) {
-        util::remove_old_files(cache_bin_dir, cache_file_max);
+        util::remove_old_files(cache_bin_dir, cache_file_max, ".clbin");
     }
 }
 
@@ -23,8 +23,10 @@ If not, see <http://www.gnu.org/licenses/>.
 #include <fstream>
 #include <string>
 #include <map>
+#include <set>
 #include <iomanip>
 #include <dlfcn.h>
+#include <unistd.h>
 #include <bohrium/jitk/codegen_util.hpp>
 #include <bohrium/jitk/compiler.hpp>
 #include <bohrium/jitk/fuser_cache.hpp>
@@ -33,8 +35,10 @@ If not, see <http://www.gnu.org/licenses/>.
 #include <thread>
 
 #include <bohrium/bh_util.hpp>
+#include <bohrium/bh_malloc_cache.hpp>
 #include "engine_openmp.hpp"
 #include "openmp_util.hpp"
+#include "interpreter.hpp"
 
 using namespace std;
 using namespace bohrium::jitk;
@@ -42,12 +46,121 @@ namespace fs = boost::filesystem;
 
 namespace bohrium {
 
+namespace {
+// Detect the widest vector width (in bytes) of the CPU and the GCC target that enables it
+void detect_simd(uint64_t &width, string &target) {
+    width = 16;
+    target = "";
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        width = 64;
+        target = "avx512f";
+    } else if (__builtin_cpu_supports("avx2")) {
+        width = 32;
+        target = "avx2";
+    }
+#endif
+}
+
+// Is `opcode` written as a plain C operator (rather than a call to a math function)?
+bool is_operator_opcode(bh_opcode opcode) {
+    switch (opcode) {
+        case BH_IDENTITY:
+        case BH_ADD:
+        case BH_SUBTRACT:
+        case BH_MULTIPLY:
+        case BH_DIVIDE:
+        case BH_MAXIMUM:
+        case BH_MINIMUM:
+        case BH_GREATER:
+        case BH_GREATER_EQUAL:
+        case BH_LESS:
+        case BH_LESS_EQUAL:
+        case BH_EQUAL:
+        case BH_NOT_EQUAL:
+        case BH_LOGICAL_AND:
+        case BH_LOGICAL_OR:
+        case BH_LOGICAL_XOR:
+        case BH_LOGICAL_NOT:
+        case BH_ADD_REDUCE:
+        case BH_MULTIPLY_REDUCE:
+        case BH_MAXIMUM_REDUCE:
+        case BH_MINIMUM_REDUCE:
+        case BH_ADD_ACCUMULATE:
+        case BH_MULTIPLY_ACCUMULATE:
+        case BH_RANGE:
+        case BH_GATHER:
+        case BH_SCATTER:
+        case BH_COND_SCATTER:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Does `kernel` need <complex.h> and <tgmath.h>? That is, does it use complex types or call a math function
+// on a float32, which <math.h> would evaluate in double precision. Other kernels only need <math.h>.
+bool uses_type_generic_math(const jitk::LoopB &kernel) {
+    for (const jitk::InstrPtr &instr: jitk::iterator::allInstr(kernel)) {
+        if (bh_opcode_is_system(instr->opcode)) {
+            continue;
+        }
+        for (size_t i = 0; i < instr->operand.size(); ++i) {
+            const bh_type type = instr->operand_type(static_cast<int>(i));
+            if (bh_type_is_complex(type) or (type == bh_type::FLOAT32 and not is_operator_opcode(instr->opcode))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// The default compile command of tier 1 kernels: `cmd` with the optimization flags of config.ini, which come after
+// the flags of `cmd` thus they take precedence
+string optimized_compiler_cmd(const string &cmd) {
+    const string flags = "-O3 -march=native -funroll-loops ";
+    const size_t pos = cmd.find("{IN}");
+    if (pos == string::npos) {
+        return cmd;
+    }
+    return cmd.substr(0, pos) + flags + cmd.substr(pos);
+}
+}
+
 EngineOpenMP::EngineOpenMP(component::ComponentVE &comp, jitk::Statistics &stat) : EngineCPU(comp, stat), compiler(
-        comp.config.get<string>("compiler_cmd"), comp.config.file_dir.string(), verbose), compiler_openmp(
+        comp.config.get<string>("compiler_cmd"), comp.config.file_dir.string(), verbose), compiler_backend(
+        comp.config.defaultGet<string>("compiler_backend", "subprocess")), compiler_openmp(
         comp.config.defaultGet<bool>("compiler_openmp", false)), compiler_openmp_simd(
-        comp.config.defaultGet<bool>("compiler_openmp_simd", false)) {
+        comp.config.defaultGet<bool>("compiler_openmp_simd", false)), compiler_simd(
+        comp.config.defaultGet<bool>("compiler_simd", false)), simd_width(
+        comp.config.defaultGet<uint64_t>("compiler_simd_width", 0)), async_compile(
+        comp.config.defaultGet<bool>("async_compile", false)), async_compile_jobs(
+        comp.config.defaultGet<uint64_t>("async_compile_jobs", 4)), compile_batch(
+        comp.config.defaultGet<bool>("compile_batch", false)), tier_compiler_cmd(
+        comp.config.defaultGet<string>("tier_compiler_cmd", optimized_compiler_cmd(compiler.cmd_template))) {
 
     compilation_hash = util::hash(compiler.cmd_template);
+    tier_compilation_hash = util::hash(tier_compiler_cmd);
+
+    if (simd_width == 0) {
+        detect_simd(simd_width, simd_target);
+    } else if (simd_width < 8 or (simd_width & (simd_width - 1)) != 0) {
+        throw std::runtime_error("config: `compiler_simd_width` must be zero or a power of two of at least 8");
+    }
+
+    if (compiler_backend == "libtcc") {
+        // The in-process compiler is an optimization thus we use the subprocess compiler when libtcc is missing
+        try {
+            compiler_tcc.reset(new jitk::CompilerTCC(compiler.cmd_template,
+                                                     comp.config.defaultGet<string>("compiler_tcc_lib", "libtcc.so"),
+                                                     verbose));
+        } catch (const std::runtime_error &e) {
+            cerr << "Warning: " << e.what() << ", falling back to the subprocess compiler" << endl;
+        }
+    } else if (compiler_backend != "subprocess") {
+        throw std::runtime_error("config: `compiler_backend` must be 'subprocess' or 'libtcc'");
+    }
 
     // Initiate cache limits
     malloc_cache_limit_in_percent = comp.config.defaultGet<int64_t>("malloc_cache_limit", 80);
@@ -65,21 +178,137 @@ EngineOpenMP::EngineOpenMP(component::ComponentVE &comp, jitk::Statistics &stat)
                                                                       (malloc_cache_limit_in_percent / 100.0)));
     }
     bh_set_malloc_cache_limit(static_cast<uint64_t>(malloc_cache_limit_in_bytes));
+
+    // The size tolerance (in percent) when reusing cached allocations
+    const int64_t malloc_cache_tolerance = comp.config.defaultGet<int64_t>(
+            "malloc_cache_tolerance", std::lround(MallocCache::DEFAULT_TOLERANCE * 100));
+    if (malloc_cache_tolerance < 0) {
+        throw std::runtime_error("config: `malloc_cache_tolerance` must be non-negative");
+    }
+    bh_set_malloc_cache_tolerance(malloc_cache_tolerance / 100.0);
+
+    // The NUMA placement, page size, and prefaulting of large arrays
+    const NumaPolicy numa_policy = bh_numa_policy_from_string(comp.config.defaultGet<string>("numa_policy", "none"));
+    const uint64_t numa_threshold = comp.config.defaultGet<uint64_t>("numa_threshold", 4194304);
+    const PagePolicy page_policy = bh_page_policy_from_string(comp.config.defaultGet<string>("page_policy", "none"));
+    const uint64_t page_threshold = comp.config.defaultGet<uint64_t>("page_threshold", 4194304);
+    const PrefaultPolicy prefault = bh_prefault_policy_from_string(comp.config.defaultGet<string>("prefault", "none"));
+    const uint64_t prefault_threshold = comp.config.defaultGet<uint64_t>("prefault_threshold", 4194304);
+    std::function<void(void *, uint64_t)> parallel_touch;
+    if (numa_policy == NumaPolicy::FIRST_TOUCH or prefault == PrefaultPolicy::PARALLEL) {
+        // The pages are touched by a kernel with the same OpenMP static schedule as the kernels that use the array.
+        // NB: we compile it here since `bh_data_malloc()` might be called from a task thread
+        const string source = "#include <stdint.h>\n"
+                              "void first_touch(void* data_list[], uint64_t offset_strides[], void *constants) {\n"
+                              "    char *mem = data_list[0];\n"
+                              "    const uint64_t nbytes = offset_strides[0];\n"
+                              "    const uint64_t page_size = offset_strides[1];\n"
+                              "    #pragma omp parallel for schedule(static)\n"
+                              "    for(uint64_t i = 0; i < nbytes; i += page_size) {\n"
+                              "        mem[i] = 0;\n"
+                              "    }\n"
+                              "}\n";
+        // NB: libtcc ignores OpenMP thus we use the subprocess compiler
+        const KernelFunction func = getFunction(source, "first_touch", compiler.cmd_template);
+        const uint64_t page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        parallel_touch = [func, page_size](void *mem, uint64_t nbytes) {
+            void *data_list[] = {mem};
+            uint64_t offset_strides[] = {nbytes, page_size};
+            func(data_list, offset_strides, nullptr);
+        };
+    }
+    bh_set_numa_policy(numa_policy, numa_threshold, parallel_touch);
+
+    // Concurrent kernels share the OpenMP threads evenly, thus the task threads don't oversubscribe the CPU.
+    // NB: the share is based on the tasks that are ready, thus a kernel that runs alone gets all the threads.
+    if (task_scheduler and compiler_openmp) {
+        const string source = "#include <stdint.h>\n"
+                              "int omp_get_max_threads(void);\n"
+                              "void omp_set_num_threads(int num_threads);\n"
+                              "void set_num_threads(void* data_list[], uint64_t offset_strides[], void *constants) {\n"
+                              "    if (offset_strides[0] == 0) {\n"
+                              "        offset_strides[0] = omp_get_max_threads();\n"
+                              "    } else {\n"
+                              "        omp_set_num_threads((int) offset_strides[0]);\n"
+                              "    }\n"
+                              "}\n";
+        // NB: libtcc ignores OpenMP thus we use the subprocess compiler
+        const KernelFunction func = getFunction(source, "set_num_threads", compiler.cmd_template);
+        uint64_t max_threads[] = {0};
+        func(nullptr, max_threads, nullptr);
+        const uint64_t total_threads = max_threads[0];
+        set_task_threads = [func, total_threads](size_t num_tasks) {
+            uint64_t offset_strides[] = {std::max(total_threads / std::max(num_tasks, size_t{1}), uint64_t{1})};
+            func(nullptr, offset_strides, nullptr);
+        };
+    }
+    bh_set_page_policy(page_policy, page_threshold, prefault, prefault_threshold, parallel_touch);
+
+    // Spill arrays to disk when they exceed the budget
+    bh_set_spill_budget(comp.config.defaultGet<uint64_t>("spill_budget", 0),
+                        comp.config.defaultGet<boost::filesystem::path>("spill_dir",
+                                                                       jitk::get_tmp_path(comp.config)).string());
+
+    // The page fault counters are relative to the first call
+    bh_get_page_fault_stat(stat.page_faults_minor, stat.page_faults_major, stat.dtlb_misses);
 }
 
 EngineOpenMP::~EngineOpenMP() {
     const bool use_cache = not (cache_readonly or cache_bin_dir.empty());
 
+    // The memory policies might refer to `parallel_touch`, which is code of this library. Since the library is
+    // unloaded after the engine, we reset the policies before the memory allocator can call or destroy it.
+    bh_set_numa_policy(NumaPolicy::NONE, 0, nullptr);
+    bh_set_page_policy(PagePolicy::NONE, 0, PrefaultPolicy::NONE, 0, nullptr);
+
+    // Wait for the background compilations to finish (errors are ignored since the kernels are never used)
+    for (auto &pending: _pending_compilations) {
+        pending.second.compile_time.wait();
+    }
+    for (auto &pending: _pending_tier_ups) {
+        pending.second.compile_time.wait();
+    }
+
     // Move JIT kernels to the cache dir
     if (use_cache) {
         try {
+            vector<uint64_t> kernel_hashes;
             for (const auto &kernel: _functions) {
-                const fs::path src = tmp_bin_dir / jitk::hash_filename(compilation_hash, kernel.first, ".so");
+                kernel_hashes.push_back(kernel.first);
+            }
+            for (const auto &pending: _pending_compilations) {
+                kernel_hashes.push_back(pending.first);
+            }
+            for (uint64_t hash: kernel_hashes) {
+                const fs::path src = tmp_bin_dir / jitk::hash_filename(compilation_hash, hash, ".so");
+                if (fs::exists(src)) {
+                    const fs::path dst = cache_bin_dir / jitk::hash_filename(compilation_hash, hash, ".so");
+                    fs::copy_file(src, dst, fs::copy_option::overwrite_if_exists);
+                }
+            }
+            // The tier 1 kernels are named after the tier 1 compile command
+            set<uint64_t> tier_hashes = _tier_functions;
+            for (const auto &pending: _pending_tier_ups) {
+                tier_hashes.insert(pending.first);
+            }
+            for (uint64_t hash: tier_hashes) {
+                const fs::path src = tmp_bin_dir / jitk::hash_filename(tier_compilation_hash, hash, ".so");
                 if (fs::exists(src)) {
-                    const fs::path dst = cache_bin_dir / jitk::hash_filename(compilation_hash, kernel.first, ".so");
+                    const fs::path dst = cache_bin_dir / jitk::hash_filename(tier_compilation_hash, hash, ".so");
                     fs::copy_file(src, dst, fs::copy_option::overwrite_if_exists);
                 }
             }
+            // A batch library is copied once and each of its kernels becomes a symlink to the library
+            for (const auto &batch: _batch_libs) {
+                fs::copy_file(tmp_bin_dir / batch.first, cache_bin_dir / batch.first,
+                              fs::copy_option::overwrite_if_exists);
+                for (uint64_t hash: batch.second) {
+                    const fs::path dst = cache_bin_dir / jitk::hash_filename(compilation_hash, hash, ".so");
+                    if (not fs::exists(fs::symlink_status(dst))) {
+                        fs::create_symlink(batch.first, dst);
+                    }
+                }
+            }
         } catch (const boost::filesystem::filesystem_error &e) {
             cout << "Warning: couldn't write JIT kernels to disk to " << cache_bin_dir
                  << ". " << e.what() << endl;
@@ -92,7 +321,7 @@ EngineOpenMP::~EngineOpenMP() {
     }
 
     if (cache_file_max != -1 and use_cache) {
-        util::remove_old_files(cache_bin_dir, cache_file_max);
+        util::remove_old_files(cache_bin_dir, cache_file_max, ".so");
     }
 
     // If this cleanup is enabled, the application segfaults
@@ -133,11 +362,26 @@ KernelFunction EngineOpenMP::getFunction(const string &source, const string &fun
     
     // Let's try to load the shared library. If it fails for any reason, we try again after a compilation.
     void *lib_handle = dlopen(binfile.string().c_str(), RTLD_NOW);
+    if (lib_handle != nullptr) {
+        _lib_handles.push_back(lib_handle);
+    }
 
     // If the binary file couldn't load, we compile it.
     if (verbose or cache_bin_dir.empty() or lib_handle == nullptr) {
         ++stat.kernel_cache_misses;
 
+        // Let's try the in-process compiler first
+        if (compile_cmd.empty() and inProcessCompatible(source)) {
+            const auto tbuild = chrono::steady_clock::now();
+            *(void **) (&_functions[hash]) = compiler_tcc->compile(source, func_name);
+            if (_functions.at(hash) != nullptr) {
+                stat.time_compile_per_backend["libtcc"].register_exec_time(chrono::steady_clock::now() - tbuild);
+                return _functions.at(hash);
+            }
+            _functions.erase(hash);
+        }
+        const auto tbuild = chrono::steady_clock::now();
+
         // We create the binary file in the tmp dir
         binfile = tmp_bin_dir / jitk::hash_filename(compilation_hash, hash, ".so");
 
@@ -159,17 +403,28 @@ KernelFunction EngineOpenMP::getFunction(const string &source, const string &fun
                 compiler.compile(binfile, source, compile_cmd);
             }
         }
+        stat.time_compile_per_backend["subprocess"].register_exec_time(chrono::steady_clock::now() - tbuild);
     }
 
-    // If the library wasn't loaded before compilation, we try one more time
+    // Load the launcher function (if the library wasn't loaded before compilation, we try one more time)
+    return loadFunction(binfile, hash, func_name, lib_handle);
+}
+
+void *EngineOpenMP::openLibrary(const fs::path &binfile) {
+    void *lib_handle = dlopen(binfile.string().c_str(), RTLD_NOW);
     if (lib_handle == nullptr) {
-        lib_handle = dlopen(binfile.string().c_str(), RTLD_NOW);
-        if (lib_handle == nullptr) {
-            cerr << "Cannot load library: " << dlerror() << endl;
-            throw runtime_error("VE-OPENMP: Cannot load library");
-        }
+        cerr << "Cannot load library: " << dlerror() << endl;
+        throw runtime_error("VE-OPENMP: Cannot load library");
     }
     _lib_handles.push_back(lib_handle);
+    return lib_handle;
+}
+
+KernelFunction EngineOpenMP::loadFunction(const fs::path &binfile, uint64_t hash, const string &func_name,
+                                          void *lib_handle) {
+    if (lib_handle == nullptr) {
+        lib_handle = openLibrary(binfile);
+    }
 
     // Load the launcher function
     // The (clumsy) cast conforms with the ISO C standard and will
@@ -184,21 +439,191 @@ KernelFunction EngineOpenMP::getFunction(const string &source, const string &fun
     return _functions.at(hash);
 }
 
+void EngineOpenMP::installFinishedCompilations() {
+    for (auto it = _pending_compilations.begin(); it != _pending_compilations.end();) {
+        if (it->second.compile_time.wait_for(chrono::seconds(0)) != future_status::ready) {
+            ++it;
+            continue;
+        }
+        const uint64_t hash = it->first;
+        PendingCompilation pending = std::move(it->second);
+        it = _pending_compilations.erase(it);
+        // NB: `get()` re-throws any compilation error
+        const chrono::duration<double> tbuild = pending.compile_time.get();
+        stat.time_async_compile += tbuild;
+        stat.time_compile_per_backend["subprocess-async"].register_exec_time(tbuild);
+        loadFunction(tmp_bin_dir / jitk::hash_filename(compilation_hash, hash, ".so"), hash, pending.func_name);
+    }
+
+    for (auto it = _pending_tier_ups.begin(); it != _pending_tier_ups.end();) {
+        if (it->second.compile_time.wait_for(chrono::seconds(0)) != future_status::ready) {
+            ++it;
+            continue;
+        }
+        const uint64_t hash = it->first;
+        PendingCompilation pending = std::move(it->second);
+        it = _pending_tier_ups.erase(it);
+        try {
+            const chrono::duration<double> tbuild = pending.compile_time.get();
+            stat.time_async_compile += tbuild;
+            stat.time_compile_per_backend["subprocess-tier1"].register_exec_time(tbuild);
+            loadFunction(tmp_bin_dir / jitk::hash_filename(tier_compilation_hash, hash, ".so"), hash,
+                         pending.func_name);
+        } catch (const std::exception &e) {
+            // Tier 1 is an optimization thus the kernel keeps running its tier 0 function
+            cerr << "Warning: the tier 1 compilation of a kernel failed, it stays at tier 0: " << e.what() << endl;
+            _functions.erase(hash);
+            _failed_tier_ups.insert(hash);
+            continue;
+        }
+        _tier_functions.insert(hash);
+    }
+}
+
+KernelFunction EngineOpenMP::getFunctionAsync(const string &source, const string &func_name) {
+    const uint64_t hash = util::hash(source);
+
+    installFinishedCompilations();
+    if (util::exist(_pending_compilations, hash)) {
+        return nullptr;
+    }
+
+    // We use the regular (blocking) path when the kernel is ready, when it is in the cache dir,
+    // when writing source files in verbose mode, or when too many compilations are in flight.
+    const fs::path cached = cache_bin_dir / jitk::hash_filename(compilation_hash, hash, ".so");
+    if (util::exist(_functions, hash) or verbose or
+        (not cache_bin_dir.empty() and fs::exists(cached)) or
+        _pending_compilations.size() >= async_compile_jobs) {
+        return getFunction(source, func_name);
+    }
+
+    ++stat.kernel_cache_lookups;
+    ++stat.kernel_cache_misses;
+    const fs::path binfile = tmp_bin_dir / jitk::hash_filename(compilation_hash, hash, ".so");
+    PendingCompilation &pending = _pending_compilations[hash];
+    pending.func_name = func_name;
+    pending.compile_time = std::async(std::launch::async, [this, binfile, source]() {
+        const auto tbuild = chrono::steady_clock::now();
+        compiler.compile(binfile, source);
+        return chrono::duration<double>(chrono::steady_clock::now() - tbuild);
+    });
+    return nullptr;
+}
+
+bool EngineOpenMP::tierReady(const string &source, uint64_t codegen_hash) {
+    const uint64_t hash = util::hash(source);
+
+    installFinishedCompilations();
+    if (util::exist(_tier_functions, hash)) {
+        return true;
+    }
+    if (util::exist(_pending_tier_ups, hash) or util::exist(_failed_tier_ups, hash)) {
+        return false;
+    }
+    stringstream func_name;
+    func_name << "launcher_" << codegen_hash;
+
+    const fs::path cached = cache_bin_dir / jitk::hash_filename(tier_compilation_hash, hash, ".so");
+    if (not cache_bin_dir.empty() and fs::exists(cached)) {
+        loadFunction(cached, hash, func_name.str());
+        _tier_functions.insert(hash);
+        return true;
+    }
+    // Tier 1 is an optimization thus we simply try again later when too many compilations are in flight
+    if (_pending_tier_ups.size() < async_compile_jobs) {
+        ++stat.num_tier_ups;
+        const fs::path binfile = tmp_bin_dir / jitk::hash_filename(tier_compilation_hash, hash, ".so");
+        PendingCompilation &pending = _pending_tier_ups[hash];
+        pending.func_name = func_name.str();
+        pending.compile_time = std::async(std::launch::async, [this, binfile, source]() {
+            const auto tbuild = chrono::steady_clock::now();
+            compiler.compile(binfile, source, tier_compiler_cmd);
+            return chrono::duration<double>(chrono::steady_clock::now() - tbuild);
+        });
+    }
+    return false;
+}
+
+void EngineOpenMP::prepare(const vector<const jitk::LoopB *> &kernels,
+                           const vector<string> &sources,
+                           const vector<uint64_t> &codegen_hashes) {
+    if (not compile_batch or verbose) {
+        return;
+    }
+
+    // Find the kernels that `getFunction()` would have to compile
+    vector<size_t> new_kernels;
+    set<uint64_t> batch_hashes;
+    set<uint64_t> batch_codegen_hashes; // NB: the launcher names must be unique within the batch
+    for (size_t i = 0; i < kernels.size(); ++i) {
+        const uint64_t hash = util::hash(sources[i]);
+        if (util::exist(_functions, hash) or util::exist(_pending_compilations, hash) or
+            util::exist(batch_hashes, hash) or util::exist(batch_codegen_hashes, codegen_hashes[i])) {
+            continue;
+        }
+        // Kernels handled by the background compilation are left alone and
+        // the in-process compiler is cheap enough to compile one kernel at a time
+        if ((async_compile and interpreter_compatible(*kernels[i])) or inProcessCompatible(sources[i])) {
+            continue;
+        }
+        if (not cache_bin_dir.empty() and
+            fs::exists(cache_bin_dir / jitk::hash_filename(compilation_hash, hash, ".so"))) {
+            continue;
+        }
+        batch_hashes.insert(hash);
+        batch_codegen_hashes.insert(codegen_hashes[i]);
+        new_kernels.push_back(i);
+    }
+    // A single kernel is simply compiled by `getFunction()`
+    if (new_kernels.size() < 2) {
+        return;
+    }
+
+    const auto tbuild = chrono::steady_clock::now();
+    // NB: the first kernel declares `union dtype`, which must include the complex types of the other kernels
+    string batch_source = "#include <complex.h>\n#include <tgmath.h>\n";
+    for (size_t i: new_kernels) {
+        batch_source += sources[i];
+        batch_source += "\n";
+    }
+    const string batch_filename = jitk::hash_filename(compilation_hash, util::hash(batch_source), ".so");
+    const fs::path binfile = tmp_bin_dir / batch_filename;
+    compiler.compile(binfile, batch_source);
+
+    void *lib_handle = openLibrary(binfile);
+    vector<uint64_t> &lib_kernels = _batch_libs[batch_filename];
+    for (size_t i: new_kernels) {
+        const uint64_t hash = util::hash(sources[i]);
+        stringstream func_name;
+        func_name << "launcher_" << codegen_hashes[i];
+        loadFunction(binfile, hash, func_name.str(), lib_handle);
+        lib_kernels.push_back(hash);
+    }
+    // The lookups are counted when the kernels are executed
+    stat.kernel_cache_misses += new_kernels.size();
+    ++stat.num_batch_compilations;
+    stat.time_compile += chrono::steady_clock::now() - tbuild;
+    stat.time_compile_per_backend["subprocess-batch"].register_exec_time(chrono::steady_clock::now() - tbuild);
+}
 
-void EngineOpenMP::execute(const jitk::SymbolTable &symbols,
+void EngineOpenMP::execute(const jitk::LoopB &kernel,
+                           const jitk::SymbolTable &symbols,
                            const std::string &source,
                            uint64_t codegen_hash,
                            const std::vector<const bh_instruction *> &constants) {
+    getLauncher(kernel, symbols, source, codegen_hash, constants)();
+}
+
+std::function<void()> EngineOpenMP::getLauncher(const jitk::LoopB &kernel,
+                                                const jitk::SymbolTable &symbols,
+                                                const std::string &source,
+                                                uint64_t codegen_hash,
+                                                const std::vector<const bh_instruction *> &constants) {
     // Notice, we use a "pure" hash of `source` to make sure that the `source_filename` always
     // corresponds to `source` even if `codegen_hash` is buggy.
     uint64_t hash = util::hash(source);
     std::string source_filename = jitk::hash_filename(compilation_hash, hash, ".c");
 
-    // Make sure all arrays are allocated
-    for (bh_base *base: symbols.getParams()) {
-        bh_data_malloc(base);
-    }
-
     // Compile the kernel
     auto tbuild = chrono::steady_clock::now();
     string func_name;
@@ -207,21 +632,31 @@ void EngineOpenMP::execute(const jitk::SymbolTable &symbols,
         t << "launcher_" << codegen_hash;
         func_name = t.str();
     }
-    KernelFunction func = getFunction(source, func_name);
-    assert(func != nullptr);
+    KernelFunction func;
+    // NB: the in-process compiler is fast enough to compile in the foreground
+    if (async_compile and not inProcessCompatible(source) and interpreter_compatible(kernel)) {
+        func = getFunctionAsync(source, func_name);
+    } else {
+        func = getFunction(source, func_name);
+        assert(func != nullptr);
+    }
     stat.time_compile += chrono::steady_clock::now() - tbuild;
 
-    // Create a 'data_list' of data pointers
-    vector<void *> data_list;
-    data_list.reserve(symbols.getParams().size());
-    for (bh_base *base: symbols.getParams()) {
-        assert(base->getDataPtr() != nullptr);
-        data_list.push_back(base->getDataPtr());
+    // The kernel is still being compiled, thus we use the interpreter
+    // NB: the interpreter allocates the arrays it needs
+    if (func == nullptr) {
+        ++stat.num_interpreted_kernels;
+        return [this, &kernel]() {
+            std::lock_guard<std::mutex> lock(memory_mutex);
+            const auto tinterpret = chrono::steady_clock::now();
+            interpret(kernel);
+            stat.time_interpret += chrono::steady_clock::now() - tinterpret;
+        };
     }
 
-    // And the offset-and-strides
+    // And the offset-and-strides followed by the sizes of the loops
     vector<uint64_t> offset_and_strides;
-    offset_and_strides.reserve(symbols.offsetStrideViews().size());
+    offset_and_strides.reserve(symbols.offsetStrideViews().size() + symbols.loopSizes().size());
     for (const bh_view *view: symbols.offsetStrideViews()) {
         const uint64_t t = (uint64_t) view->start;
         offset_and_strides.push_back(t);
@@ -230,6 +665,9 @@ void EngineOpenMP::execute(const jitk::SymbolTable &symbols,
             offset_and_strides.push_back(s);
         }
     }
+    for (int64_t size: symbols.loopSizes()) {
+        offset_and_strides.push_back(static_cast<uint64_t>(size));
+    }
 
     // And the constants
     vector<bh_constant_value> constant_arg;
@@ -238,13 +676,26 @@ void EngineOpenMP::execute(const jitk::SymbolTable &symbols,
         constant_arg.push_back(instr->constant.value);
     }
 
-    auto start_exec = chrono::steady_clock::now();
-    // Call the launcher function, which will execute the kernel
-    func(&data_list[0], &offset_and_strides[0], &constant_arg[0]);
-    auto texec = chrono::steady_clock::now() - start_exec;
-    stat.time_exec += texec;
-    stat.time_per_kernel[source_filename].register_exec_time(texec);
-
+    const vector<bh_base *> params = symbols.getParams();
+    return [this, func, params, offset_and_strides, constant_arg, source_filename]() mutable {
+        // Make sure all arrays are allocated and create a 'data_list' of data pointers
+        vector<void *> data_list;
+        data_list.reserve(params.size());
+        {
+            std::lock_guard<std::mutex> lock(memory_mutex);
+            for (bh_base *base: params) {
+                bh_data_malloc(base);
+                data_list.push_back(base->getDataPtr());
+            }
+        }
+        auto start_exec = chrono::steady_clock::now();
+        // Call the launcher function, which will execute the kernel
+        func(&data_list[0], &offset_and_strides[0], &constant_arg[0]);
+        auto texec = chrono::steady_clock::now() - start_exec;
+        std::lock_guard<std::mutex> lock(_stat_mutex);
+        stat.time_exec += texec;
+        stat.time_per_kernel[source_filename].register_exec_time(texec);
+    };
 }
 
 // Writes the OpenMP specific for-loop header
@@ -255,6 +706,22 @@ void EngineOpenMP::loopHeadWriter(const jitk::SymbolTable &symbols,
                                   stringstream &out) {
     // Let's write the OpenMP loop header
     int64_t for_loop_size = block.size;
+    // Accumulates are executed as a parallel prefix scan
+    if (compiler_openmp and for_loop_size > 1 and parallel_scan_compatible(block, scope)) {
+        writeScanHead(symbols, scope, block, out);
+        return;
+    }
+    // Contiguous innermost loops are vectorized explicitly and the for-loop below becomes the scalar remainder.
+    // NB: when the size is a variable, the vector loop is written for all sizes and covers zero iterations when
+    //     the loop is too short.
+    string first_index = "0";
+    bh_type dtype;
+    if (compiler_simd and vector_compatible(block, scope, dtype) and
+        (symbols.shape_as_var ? for_loop_size > 1 :
+         for_loop_size >= 2 * static_cast<int64_t>(simd_width / bh_type_size(dtype)))) {
+        first_index = writeVectorLoop(symbols, scope, block, dtype, out);
+        util::spaces(out, 4 + block.rank * 4);
+    }
     // No need to parallel one-sized loops
     if (for_loop_size > 1) {
         writeHeader(symbols, scope, block, out);
@@ -266,8 +733,257 @@ void EngineOpenMP::loopHeadWriter(const jitk::SymbolTable &symbols,
         t << "i" << block.rank;
         itername = t.str();
     }
-    out << "for(uint64_t " << itername << " = 0; ";
-    out << itername << " < " << block.size << "; ++" << itername << ") {\n";
+    out << "for(uint64_t " << itername << " = " << first_index << "; ";
+    out << itername << " < " << symbols.loopSize(block) << "; ++" << itername << ") {\n";
+}
+
+namespace {
+// Write the value of 'view' in 'instr' broadcasted to all 'lanes' of a vector of type 'vec_type'
+void write_vector_broadcast(const jitk::Scope &scope, const bh_instruction &instr, const bh_view &view,
+                            const string &vec_type, uint64_t lanes, stringstream &out) {
+    stringstream value;
+    if (view.isConstant()) {
+        const int64_t constID = scope.symbols.constID(instr);
+        if (constID >= 0) {
+            value << "c" << constID;
+        } else {
+            instr.constant.pprint(value, false);
+        }
+    } else {
+        scope.getName(view, value);
+        if (scope.isArray(view)) {
+            write_array_subscription(scope, view, value, true);
+        }
+    }
+    out << "((" << vec_type << "){";
+    for (uint64_t i = 0; i < lanes; ++i) {
+        out << (i == 0 ? "" : ", ") << value.str();
+    }
+    out << "})";
+}
+
+// Write the vector operand 'view' of 'instr' where 'vector_tmps' are the temporary arrays declared as vectors
+void write_vector_operand(const jitk::Scope &scope, const bh_instruction &instr, const bh_view &view,
+                          const set<const bh_base *> &vector_tmps, const string &vec_type, uint64_t lanes,
+                          stringstream &out) {
+    if (not view.isConstant() and util::exist(vector_tmps, view.base)) {
+        scope.getName(view, out);
+    } else if (view.isConstant() or scope.isDeclared(view) or view.is_scalar()) {
+        write_vector_broadcast(scope, instr, view, vec_type, lanes, out);
+    } else {
+        out << "(*(" << vec_type << " *)&";
+        scope.getName(view, out);
+        write_array_subscription(scope, view, out, true);
+        out << ")";
+    }
+}
+}
+
+std::string EngineOpenMP::writeVectorLoop(const jitk::SymbolTable &symbols,
+                                          const jitk::Scope &scope,
+                                          const jitk::LoopB &block,
+                                          bh_type dtype,
+                                          std::stringstream &out) {
+    const uint64_t lanes = simd_width / bh_type_size(dtype);
+    const string vec_type = string("vec_") + bh_type_text(dtype);
+
+    // The vector loop covers the largest multiple of `lanes` when all arrays are contiguous along the loop.
+    // NB: when the strides are variables, the contiguity is checked at runtime.
+    const set<bh_base *> local_tmps = block.getLocalTemps();
+    set<string> conditions;
+    for (const jitk::InstrPtr &instr: jitk::iterator::allLocalInstr(block)) {
+        for (const bh_view &view: instr->getViews()) {
+            if (util::exist(local_tmps, view.base) and not symbols.isAlwaysArray(view.base)) {
+                continue;
+            }
+            if (scope.isArray(view) and not view.is_scalar() and symbols.strides_as_var and
+                symbols.existOffsetStridesID(view)) {
+                stringstream ss;
+                ss << "vs" << symbols.offsetStridesID(view) << "_" << block.rank << " == 1";
+                conditions.insert(ss.str());
+            }
+        }
+    }
+    stringstream vector_size;
+    if (symbols.shape_as_var) {
+        vector_size << "(" << symbols.loopSize(block) << " / " << lanes << " * " << lanes << ")";
+    } else {
+        vector_size << block.size / lanes * lanes;
+    }
+    stringstream vector_end;
+    if (conditions.empty()) {
+        vector_end << vector_size.str();
+    } else {
+        vector_end << "(";
+        for (auto it = conditions.begin(); it != conditions.end(); ++it) {
+            vector_end << (it == conditions.begin() ? "" : " && ") << "(" << *it << ")";
+        }
+        vector_end << " ? " << vector_size.str() << " : 0)";
+    }
+
+    if (compiler_openmp and block.rank == 0) {
+        out << "#pragma omp parallel for\n";
+        util::spaces(out, 4);
+    }
+    out << "for(uint64_t i" << block.rank << " = 0; i" << block.rank << " < " << vector_end.str() << "; i"
+        << block.rank << " += " << lanes << ") { // Vectorized with " << lanes << " lanes\n";
+
+    // The temporary arrays of 'block' become vector variables
+    jitk::Scope vscope(symbols, &scope);
+    set<const bh_base *> vector_tmps;
+    for (const jitk::InstrPtr &instr: jitk::iterator::allLocalInstr(block)) {
+        if (bh_opcode_is_system(instr->opcode)) {
+            continue;
+        }
+        const bh_view &out_view = instr->operand[0];
+        util::spaces(out, 8 + block.rank * 4);
+        if (util::exist(local_tmps, out_view.base) and not symbols.isAlwaysArray(out_view.base) and
+            not util::exist(vector_tmps, out_view.base)) {
+            vscope.insertTmp(out_view.base);
+            vector_tmps.insert(out_view.base);
+            out << vec_type << " ";
+        }
+        write_vector_operand(vscope, *instr, out_view, vector_tmps, vec_type, lanes, out);
+        out << " = ";
+        write_vector_operand(vscope, *instr, instr->operand[1], vector_tmps, vec_type, lanes, out);
+        if (instr->opcode != BH_IDENTITY) {
+            out << " " << vector_operator(instr->opcode, dtype) << " ";
+            write_vector_operand(vscope, *instr, instr->operand[2], vector_tmps, vec_type, lanes, out);
+        }
+        out << ";\n";
+    }
+    util::spaces(out, 4 + block.rank * 4);
+    out << "}\n";
+    return vector_end.str();
+}
+
+namespace {
+// Write the identity of the accumulate 'instr'
+void write_scan_identity(const jitk::InstrPtr &instr, stringstream &out) {
+    jitk::sweep_identity(instr->opcode, instr->operand[0].base->dtype()).pprint(out, false);
+}
+}
+
+/* Writes the first pass of a parallel prefix scan, which makes each thread scan its own chunk of the loop.
+ * The second pass, written by `loopTailWriter()`, adds the combined result of the previous chunks to each chunk.
+ * NB: the first element of each chunk is initiated to the identity and the accumulates read the previous element
+ *     using the per thread `i0_first` instead of zero (see `write_array_index()`).
+ */
+void EngineOpenMP::writeScanHead(const jitk::SymbolTable &symbols,
+                                 jitk::Scope &scope,
+                                 const jitk::LoopB &block,
+                                 std::stringstream &out) {
+    const std::vector<jitk::InstrPtr> ordered_block_sweeps = order_sweep_set(block._sweeps, symbols);
+    out << "{ // Parallel prefix scan\n";
+    util::spaces(out, 8);
+    out << "int omp_get_max_threads(void); int omp_get_num_threads(void); int omp_get_thread_num(void);\n";
+    for (size_t i = 0; i < ordered_block_sweeps.size(); ++i) {
+        util::spaces(out, 8);
+        out << writeType(ordered_block_sweeps[i]->operand[0].base->dtype()) << " scan_partial" << i
+            << "[omp_get_max_threads() + 1];\n";
+    }
+    util::spaces(out, 8);
+    out << "#pragma omp parallel\n";
+    util::spaces(out, 8);
+    out << "{\n";
+    util::spaces(out, 12);
+    out << "const uint64_t scan_nthds = omp_get_num_threads();\n";
+    util::spaces(out, 12);
+    out << "const uint64_t scan_tid = omp_get_thread_num();\n";
+    util::spaces(out, 12);
+    out << "const uint64_t i0_first = " << symbols.loopSize(block) << " * scan_tid / scan_nthds;\n";
+    util::spaces(out, 12);
+    out << "const uint64_t i0_last = " << symbols.loopSize(block) << " * (scan_tid + 1) / scan_nthds;\n";
+    util::spaces(out, 12);
+    out << "if (i0_first < i0_last) {\n";
+    util::spaces(out, 16);
+    out << "const uint64_t i0 = i0_first;\n";
+    for (const jitk::InstrPtr &instr: ordered_block_sweeps) {
+        util::spaces(out, 16);
+        scope.getName(instr->operand[0], out);
+        write_array_subscription(scope, instr->operand[0], out, true);
+        out << " = ";
+        write_scan_identity(instr, out);
+        out << ";\n";
+    }
+    util::spaces(out, 12);
+    out << "}\n";
+    scope.insertParallelScan(block.rank);
+    util::spaces(out, 4);
+    out << "for(uint64_t i0 = i0_first; i0 < i0_last; ++i0) {\n";
+}
+
+void EngineOpenMP::loopTailWriter(const jitk::SymbolTable &symbols,
+                                  jitk::Scope &scope,
+                                  const jitk::LoopB &block,
+                                  const vector<uint64_t> &thread_stack,
+                                  stringstream &out) {
+    if (block.rank != 0 or not scope.isParallelScan(block.rank)) {
+        return;
+    }
+    scope.eraseParallelScan(block.rank);
+    const std::vector<jitk::InstrPtr> ordered_block_sweeps = order_sweep_set(block._sweeps, symbols);
+
+    // Save the result of the chunk of this thread
+    for (size_t i = 0; i < ordered_block_sweeps.size(); ++i) {
+        util::spaces(out, 12);
+        out << "scan_partial" << i << "[scan_tid + 1] = ";
+        write_scan_identity(ordered_block_sweeps[i], out);
+        out << ";\n";
+    }
+    util::spaces(out, 12);
+    out << "if (i0_first < i0_last) {\n";
+    util::spaces(out, 16);
+    out << "const uint64_t i0 = i0_last - 1;\n";
+    for (size_t i = 0; i < ordered_block_sweeps.size(); ++i) {
+        const bh_view &view = ordered_block_sweeps[i]->operand[0];
+        util::spaces(out, 16);
+        out << "scan_partial" << i << "[scan_tid + 1] = ";
+        scope.getName(view, out);
+        write_array_subscription(scope, view, out, true);
+        out << ";\n";
+    }
+    util::spaces(out, 12);
+    out << "}\n";
+
+    // Combine the results of the chunks
+    util::spaces(out, 12);
+    out << "#pragma omp barrier\n";
+    util::spaces(out, 12);
+    out << "#pragma omp single\n";
+    util::spaces(out, 12);
+    out << "for(uint64_t t = 1; t < scan_nthds; ++t) {\n";
+    for (size_t i = 0; i < ordered_block_sweeps.size(); ++i) {
+        const char *symbol = parallel_scan_symbol(ordered_block_sweeps[i]->opcode);
+        util::spaces(out, 16);
+        out << "scan_partial" << i << "[t + 1] = scan_partial" << i << "[t] " << symbol
+            << " scan_partial" << i << "[t + 1];\n";
+    }
+    util::spaces(out, 12);
+    out << "}\n";
+
+    // The second pass, which isn't needed by the first chunk
+    util::spaces(out, 12);
+    out << "if (scan_tid > 0) {\n";
+    util::spaces(out, 16);
+    out << "for(uint64_t i0 = i0_first; i0 < i0_last; ++i0) {\n";
+    for (size_t i = 0; i < ordered_block_sweeps.size(); ++i) {
+        const char *symbol = parallel_scan_symbol(ordered_block_sweeps[i]->opcode);
+        const bh_view &view = ordered_block_sweeps[i]->operand[0];
+        stringstream element;
+        scope.getName(view, element);
+        write_array_subscription(scope, view, element, true);
+        util::spaces(out, 20);
+        out << element.str() << " = scan_partial" << i << "[scan_tid] " << symbol << " " << element.str() << ";\n";
+    }
+    util::spaces(out, 16);
+    out << "}\n";
+    util::spaces(out, 12);
+    out << "}\n";
+    util::spaces(out, 8);
+    out << "}\n";
+    util::spaces(out, 4);
+    out << "}\n";
 }
 
 // Writing the OpenMP header, which include "parallel for" and "simd"
@@ -281,6 +997,8 @@ void EngineOpenMP::writeHeader(const jitk::SymbolTable &symbols,
 
     // All reductions that can be handle directly be the OpenMP header e.g. reduction(+:var)
     std::vector<jitk::InstrPtr> openmp_reductions;
+    // Reductions to small arrays that are handled by OpenMP array sections e.g. reduction(+:a1[lo:len])
+    std::vector<jitk::InstrPtr> openmp_section_reductions;
 
     // Order all sweep instructions by the viewID of their first operand.
     // This makes the source of the kernels more identical, which improve the code and compile caches.
@@ -296,6 +1014,8 @@ void EngineOpenMP::writeHeader(const jitk::SymbolTable &symbols,
             const bh_view &view = instr->operand[0];
             if (openmp_reduce_compatible(instr->opcode) and (scope.isScalarReplaced(view) or scope.isTmp(view.base))) {
                 openmp_reductions.push_back(instr);
+            } else if (openmp_array_section_compatible(block, instr, scope)) {
+                openmp_section_reductions.push_back(instr);
             } else if (openmp_atomic_compatible(instr->opcode)) {
                 scope.insertOpenmpAtomic(instr);
             } else {
@@ -321,6 +1041,11 @@ void EngineOpenMP::writeHeader(const jitk::SymbolTable &symbols,
         scope.getName(instr->operand[0], ss);
         ss << ")";
     }
+    for (const jitk::InstrPtr &instr: openmp_section_reductions) {
+        ss << " reduction(" << openmp_reduce_symbol(instr->opcode) << ":";
+        write_openmp_array_section(scope, instr->operand[0], ss);
+        ss << ")";
+    }
     const string ss_str = ss.str();
     if (not ss_str.empty()) {
         out << "#pragma omp" << ss_str << "\n";
@@ -340,13 +1065,22 @@ void EngineOpenMP::writeKernel(const LoopB &kernel,
     ss << "#include <stdint.h>\n";
     ss << "#include <stdlib.h>\n";
     ss << "#include <stdbool.h>\n";
-    ss << "#include <complex.h>\n";
-    ss << "#include <tgmath.h>\n";
+    // NB: libtcc cannot parse <complex.h> and <tgmath.h> thus we only include them when needed
+    if (uses_type_generic_math(kernel)) {
+        ss << "#include <complex.h>\n";
+        ss << "#include <tgmath.h>\n";
+    }
     ss << "#include <math.h>\n";
     if (symbols.useRandom()) { // Write the random function
         ss << "#include <kernel_dependencies/random123_openmp.h>\n";
     }
     writeUnionType(ss); // We always need to declare the union of all constant data types
+    if (compiler_simd) {
+        if (not simd_target.empty()) {
+            ss << "#pragma GCC target(\"" << simd_target << "\")\n";
+        }
+        writeVectorTypes(ss);
+    }
     ss << "\n";
 
     // Write the header of the execute function
@@ -402,6 +1136,10 @@ void EngineOpenMP::writeKernel(const LoopB &kernel,
                 stmp << "offset_strides[" << count++ << "], ";
             }
         }
+        // The sizes of the loops follow the offset-and-strides
+        for (size_t i = 0; i < symbols.loopSizes().size(); ++i) {
+            stmp << "offset_strides[" << count++ << "], ";
+        }
 
         if (not symbols.constIDs().empty()) {
             uint64_t i = 0;
@@ -430,17 +1168,48 @@ std::string EngineOpenMP::info() const {
     ss << "  Hardware threads: " << std::thread::hardware_concurrency() << "\n";
     ss << "  Malloc cache limit: " << malloc_cache_limit_in_bytes / 1024 / 1024
        << " MB (" << malloc_cache_limit_in_percent << "% of unused memory)\n";
+    ss << "  NUMA: " << bh_numa_num_nodes() << " nodes, policy: " << comp.config.defaultGet<string>("numa_policy", "none")
+       << " (arrays of at least " << comp.config.defaultGet<uint64_t>("numa_threshold", 4194304) << " bytes)\n";
+    ss << "  Pages: " << comp.config.defaultGet<string>("page_policy", "none") << " (arrays of at least "
+       << comp.config.defaultGet<uint64_t>("page_threshold", 4194304) << " bytes), prefault: "
+       << comp.config.defaultGet<string>("prefault", "none") << " (arrays of at least "
+       << comp.config.defaultGet<uint64_t>("prefault_threshold", 4194304) << " bytes)\n";
+    if (bh_spill_enabled()) {
+        ss << "  Spill: " << comp.config.defaultGet<uint64_t>("spill_budget", 0) / 1024 / 1024 << " MB budget ("
+           << comp.config.defaultGet<boost::filesystem::path>("spill_dir", jitk::get_tmp_path(comp.config)) << ")\n";
+    }
     ss << "  Cache dir: " << comp.config.defaultGet<boost::filesystem::path>("cache_dir", "NONE")  << "\n";
     ss << "  Temp dir: " << jitk::get_tmp_path(comp.config) << "\n";
 
     ss << "  Codegen flags:\n";
     ss << "    OpenMP: " << comp.config.defaultGet<bool>("compiler_openmp", false) << "\n";
     ss << "    OpenMP+SIMD: " << comp.config.defaultGet<bool>("compiler_openmp_simd", false) << "\n";
+    ss << "    SIMD: " << compiler_simd << " (" << simd_width << " bytes";
+    if (not simd_target.empty()) {
+        ss << ", " << simd_target;
+    }
+    ss << ")\n";
     ss << "    Index-as-var: " << comp.config.defaultGet<bool>("index_as_var", true) << "\n";
     ss << "    Strides-as-var: " << comp.config.defaultGet<bool>("strides_as_var", true) << "\n";
     ss << "    Const-as-var: " << comp.config.defaultGet<bool>("const_as_var", true) << "\n";
+    ss << "    Index strength reduction: " << index_strength_reduce << "\n";
+    ss << "    Shape-as-var: " << shape_as_var << " (specialize after " << shape_specialize_threshold << ")\n";
 
+    ss << "  Tiered compile: " << tiered_compile;
+    if (tiered_compile) {
+        ss << " (after " << tier_up_calls << " calls or " << tier_up_seconds << " seconds, \""
+           << tier_compiler_cmd << "\")";
+    }
+    ss << "\n";
+    ss << "  Async compile: " << async_compile << " (" << async_compile_jobs << " jobs)\n";
+    ss << "  Batch compile: " << compile_batch << "\n";
+    ss << "  Task parallel: " << (task_scheduler != nullptr);
+    if (task_scheduler) {
+        ss << " (" << task_scheduler->numThreads() << " threads)";
+    }
+    ss << "\n";
     ss << "  JIT Command: \"" << compiler.cmd_template << "\"\n";
+    ss << "  JIT Backend: " << (compiler_tcc ? "libtcc" : "subprocess") << "\n";
     return ss.str();
 }
 
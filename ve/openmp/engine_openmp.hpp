@@ -23,12 +23,19 @@ If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <string>
 #include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <future>
+#include <chrono>
 #include <boost/filesystem.hpp>
 
 #include <bohrium/bh_config_parser.hpp>
 #include <bohrium/jitk/statistics.hpp>
 #include <bohrium/jitk/block.hpp>
 #include <bohrium/jitk/compiler.hpp>
+#include <bohrium/jitk/compiler_tcc.hpp>
 #include <bohrium/jitk/fuser_cache.hpp>
 #include <bohrium/jitk/codegen_util.hpp>
 #include <bohrium/jitk/codegen_cache.hpp>
@@ -48,25 +55,118 @@ private:
     // The compiler to use when function doesn't exist
     const jitk::Compiler compiler;
 
+    // The compiler backend: 'subprocess' runs `compiler` and 'libtcc' compiles in-process using `compiler_tcc`,
+    // which falls back to `compiler` when libtcc cannot compile a kernel
+    const std::string compiler_backend;
+    std::unique_ptr<jitk::CompilerTCC> compiler_tcc;
+
     // Generate OpenMP code?
     const bool compiler_openmp;
+    // Sets the number of OpenMP threads of the calling task thread to its share of the threads given the number
+    // of concurrent tasks (empty when the kernels aren't executed concurrently, see `limitTaskThreads()`)
+    std::function<void(size_t)> set_task_threads;
     // Generate SIMD code?
     const bool compiler_openmp_simd;
+    // Generate explicit vector code (GCC vector extensions) for contiguous innermost loops?
+    const bool compiler_simd;
+    // The vector width in bytes and the GCC target of the vector code. Both are detected from the CPU
+    // when `compiler_simd_width` is zero.
+    uint64_t simd_width;
+    std::string simd_target;
+
+    // Compile kernels in the background and interpret them until the compilation finishes?
+    const bool async_compile;
+    // The maximum number of concurrent background compilations
+    const uint64_t async_compile_jobs;
+    // A background compilation, which returns the compile time, and the name of the kernel function it compiles
+    struct PendingCompilation {
+        std::string func_name;
+        std::future<std::chrono::duration<double> > compile_time;
+    };
+    // Background compilations in flight. The key is the hash of the source.
+    std::map<uint64_t, PendingCompilation> _pending_compilations;
+
+    // Compile all new kernels of a BhIR into one shared library?
+    const bool compile_batch;
+    // The batch libraries compiled in the tmp dir mapped to the hashes of the kernels they contain
+    std::map<std::string, std::vector<uint64_t> > _batch_libs;
+
+    // The compile command of tier 1 kernels (see `tiered_compile`) and its hash, which names their shared libraries
+    const std::string tier_compiler_cmd;
+    uint64_t tier_compilation_hash;
+    // Tier 1 compilations in flight. The key is the hash of the source.
+    std::map<uint64_t, PendingCompilation> _pending_tier_ups;
+    // The source hashes of the loaded tier 1 kernels, which are registered in `_functions` like any other kernel
+    std::set<uint64_t> _tier_functions;
+    // The source hashes of the tier 1 kernels that failed to compile, which stay at tier 0
+    std::set<uint64_t> _failed_tier_ups;
+
+    // Protects the execution statistics, which the launchers update concurrently when `task_parallel` is enabled
+    std::mutex _stat_mutex;
+
+    // Return true when `source` should be compiled by the in-process compiler, which requires that libtcc is enabled,
+    // that the kernel doesn't need <tgmath.h>, and that it has no parallel loops (libtcc ignores OpenMP)
+    bool inProcessCompatible(const std::string &source) const {
+        return compiler_tcc and source.find("<tgmath.h>") == std::string::npos and
+               not (compiler_openmp and source.find("#pragma omp parallel") != std::string::npos);
+    }
+
+    // Open the shared library `binfile` and register it in `_lib_handles`
+    void *openLibrary(const boost::filesystem::path &binfile);
+
+    // Load the kernel function `func_name` from the shared library `binfile` and register it as `hash`.
+    // If `lib_handle` isn't nullptr, the library has already been opened (and registered in `_lib_handles`).
+    KernelFunction loadFunction(const boost::filesystem::path &binfile, uint64_t hash, const std::string &func_name,
+                                void *lib_handle = nullptr);
+
+    /** Load the kernels of all finished background compilations and tier-ups, thus the compilations of kernels
+     *  that never run again don't linger. A failed tier-up is reported and its kernel stays at tier 0 whereas
+     *  a failed background compilation re-throws its error.
+     */
+    void installFinishedCompilations();
 
 public:
     // Return a kernel function based on the given 'source' and the name of the kernel function
     KernelFunction getFunction(const std::string &source, const std::string &func_name,
                                const std::string &compile_cmd = "");
 
+    /** Return the kernel function if it is ready otherwise the kernel is compiled in the background
+     *  and nullptr is returned. Kernels that are already in the cache dir are loaded directly.
+     */
+    KernelFunction getFunctionAsync(const std::string &source, const std::string &func_name);
+
     EngineOpenMP(component::ComponentVE &comp, jitk::Statistics &stat);
 
     ~EngineOpenMP() override;
 
-    void execute(const jitk::SymbolTable &symbols,
+    /** Compile all kernels in `kernels` that aren't compiled (or in the cache dir) already into one
+     *  shared library, which saves a compiler invocation and a `dlopen()` per kernel.
+     */
+    void prepare(const std::vector<const jitk::LoopB *> &kernels,
+                 const std::vector<std::string> &sources,
+                 const std::vector<uint64_t> &codegen_hashes) override;
+
+    // Compile the tier 1 kernel `source` in the background using `tier_compiler_cmd`
+    bool tierReady(const std::string &source, uint64_t codegen_hash) override;
+
+    void execute(const jitk::LoopB &kernel,
+                 const jitk::SymbolTable &symbols,
                  const std::string &source,
                  uint64_t codegen_hash,
                  const std::vector<const bh_instruction*> &constants) override;
 
+    std::function<void()> getLauncher(const jitk::LoopB &kernel,
+                                      const jitk::SymbolTable &symbols,
+                                      const std::string &source,
+                                      uint64_t codegen_hash,
+                                      const std::vector<const bh_instruction *> &constants) override;
+
+    void limitTaskThreads(size_t num_tasks) override {
+        if (set_task_threads) {
+            set_task_threads(num_tasks);
+        }
+    }
+
     void writeKernel(const jitk::LoopB &kernel,
                      const jitk::SymbolTable &symbols,
                      const std::vector<bh_base *> &kernel_temps,
@@ -85,6 +185,28 @@ public:
                         const std::vector<uint64_t> &thread_stack,
                         std::stringstream &out) override;
 
+    /* Writing the vector loop of the innermost 'block' of type 'dtype', which runs when all arrays are contiguous.
+     * Returns the (C expression of the) index where the scalar remainder loop should start.
+     */
+    std::string writeVectorLoop(const jitk::SymbolTable &symbols,
+                                const jitk::Scope &scope,
+                                const jitk::LoopB &block,
+                                bh_type dtype,
+                                std::stringstream &out);
+
+    // Writing the first pass of a parallel prefix scan of the accumulates in 'block'
+    void writeScanHead(const jitk::SymbolTable &symbols,
+                       jitk::Scope &scope,
+                       const jitk::LoopB &block,
+                       std::stringstream &out);
+
+    // Writing the second pass of a parallel prefix scan (if `loopHeadWriter()` wrote the first pass)
+    void loopTailWriter(const jitk::SymbolTable &symbols,
+                        jitk::Scope &scope,
+                        const jitk::LoopB &block,
+                        const std::vector<uint64_t> &thread_stack,
+                        std::stringstream &out) override;
+
     // Return a YAML string describing this component
     std::string info() const override;
 
@@ -94,6 +216,9 @@ public:
     // Update statistics with final aggregated values of the engine
     void updateFinalStatistics() override {
         bh_get_malloc_cache_stat(stat.malloc_cache_lookups, stat.malloc_cache_misses, stat.max_memory_usage);
+        bh_get_malloc_cache_numa_stat(stat.max_memory_usage_per_numa_placement);
+        bh_get_page_fault_stat(stat.page_faults_minor, stat.page_faults_major, stat.dtlb_misses);
+        bh_get_spill_stat(stat.spilled_bytes, stat.spill_restored_bytes);
     }
 
     std::string userKernel(const std::string &kernel, std::vector<bh_view> &operand_list,
@@ -101,8 +226,11 @@ public:
 
 private:
     // Writes the union of C99 types that can make up a constant
+    // NB: the guard makes it possible to concatenate the source of multiple kernels into one translation unit
     inline void writeUnionType(std::stringstream& out) {
-        out << "\ntypedef struct { uint64_t x, y; } r123_t" << ";\n";
+        out << "\n#ifndef BH_UNION_DTYPE\n";
+        out << "#define BH_UNION_DTYPE\n";
+        out << "typedef struct { uint64_t x, y; } r123_t" << ";\n";
         out << "union dtype {\n";
         util::spaces(out, 4); out << writeType(bh_type::BOOL)       << " " << bh_type_text(bh_type::BOOL)       << ";\n";
         util::spaces(out, 4); out << writeType(bh_type::INT8)       << " " << bh_type_text(bh_type::INT8)       << ";\n";
@@ -115,10 +243,26 @@ private:
         util::spaces(out, 4); out << writeType(bh_type::UINT64)     << " " << bh_type_text(bh_type::UINT64)     << ";\n";
         util::spaces(out, 4); out << writeType(bh_type::FLOAT32)    << " " << bh_type_text(bh_type::FLOAT32)    << ";\n";
         util::spaces(out, 4); out << writeType(bh_type::FLOAT64)    << " " << bh_type_text(bh_type::FLOAT64)    << ";\n";
+        // NB: only kernels that include <complex.h> have the complex types (r123_t keeps the size of the union)
+        out << "#ifdef complex\n";
         util::spaces(out, 4); out << writeType(bh_type::COMPLEX64)  << " " << bh_type_text(bh_type::COMPLEX64)  << ";\n";
         util::spaces(out, 4); out << writeType(bh_type::COMPLEX128) << " " << bh_type_text(bh_type::COMPLEX128) << ";\n";
+        out << "#endif\n";
         util::spaces(out, 4); out << writeType(bh_type::R123)       << " " << bh_type_text(bh_type::R123)       << ";\n";
         out << "};\n";
+        out << "#endif\n";
+    }
+
+    // Writes the vector types of the explicit vector code, which are unaligned and may alias their element type
+    inline void writeVectorTypes(std::stringstream& out) {
+        out << "\n#ifndef BH_VECTOR_TYPES\n";
+        out << "#define BH_VECTOR_TYPES\n";
+        for (bh_type dtype: {bh_type::INT8, bh_type::INT16, bh_type::INT32, bh_type::INT64, bh_type::UINT8,
+                             bh_type::UINT16, bh_type::UINT32, bh_type::UINT64, bh_type::FLOAT32, bh_type::FLOAT64}) {
+            out << "typedef " << writeType(dtype) << " vec_" << bh_type_text(dtype) << " __attribute__((vector_size("
+                << simd_width << "), aligned(" << bh_type_size(dtype) << "), __may_alias__));\n";
+        }
+        out << "#endif\n";
     }
 };
 } // bohrium
@@ -0,0 +1,405 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <bohrium/bh_instruction.hpp>
+#include <bohrium/bh_main_memory.hpp>
+#include <bohrium/jitk/iterator.hpp>
+
+#include "interpreter.hpp"
+
+using namespace std;
+
+namespace bohrium {
+
+namespace { // We need some help functions
+
+// Is `type` supported by the interpreter?
+bool type_supported(bh_type type) {
+    return type == bh_type::BOOL or bh_type_is_integer(type) or bh_type_is_float(type);
+}
+
+// Is the opcode of `instr` supported by the interpreter?
+bool opcode_supported(const bh_instruction &instr) {
+    switch (instr.opcode) {
+        case BH_IDENTITY:
+        case BH_ADD:
+        case BH_SUBTRACT:
+        case BH_MULTIPLY:
+        case BH_MAXIMUM:
+        case BH_MINIMUM:
+        case BH_GREATER:
+        case BH_GREATER_EQUAL:
+        case BH_LESS:
+        case BH_LESS_EQUAL:
+        case BH_EQUAL:
+        case BH_NOT_EQUAL:
+        case BH_LOGICAL_AND:
+        case BH_LOGICAL_OR:
+        case BH_LOGICAL_XOR:
+        case BH_LOGICAL_NOT:
+        case BH_ADD_REDUCE:
+        case BH_MULTIPLY_REDUCE:
+        case BH_MAXIMUM_REDUCE:
+        case BH_MINIMUM_REDUCE:
+        case BH_LOGICAL_AND_REDUCE:
+        case BH_LOGICAL_OR_REDUCE:
+        case BH_ADD_ACCUMULATE:
+        case BH_MULTIPLY_ACCUMULATE:
+        case BH_RANGE:
+            return true;
+        // The integer versions of these opcodes have special semantics, which we leave to the JIT-compiler
+        case BH_DIVIDE:
+        case BH_ABSOLUTE:
+        case BH_SQRT:
+        case BH_EXP:
+        case BH_LOG:
+        case BH_SIN:
+        case BH_COS:
+            return bh_type_is_float(instr.operand_type(0));
+        default:
+            return false;
+    }
+}
+
+// The arithmetic type that the interpreter uses to evaluate an instruction
+enum class ArithType {
+    INT64, UINT64, FLOAT64
+};
+
+// Return the arithmetic type of `instr`, which is floating point if any operand is a float and
+// unsigned if any operand is UINT64 (the only integer type that doesn't fit in `int64_t`)
+ArithType arith_type(const bh_instruction &instr) {
+    ArithType ret = ArithType::INT64;
+    for (size_t i = 0; i < instr.operand.size(); ++i) {
+        if (instr.opcode == BH_RANGE or (bh_opcode_is_sweep(instr.opcode) and i == 2)) {
+            continue; // The range output and the sweep axis doesn't influence the arithmetic
+        }
+        const bh_type type = instr.operand_type(static_cast<int>(i));
+        if (bh_type_is_float(type)) {
+            return ArithType::FLOAT64;
+        }
+        if (type == bh_type::UINT64) {
+            ret = ArithType::UINT64;
+        }
+    }
+    return ret;
+}
+
+// Return the offset of `view` at the coordinate `coord` of the principal shape.
+// Like `jitk::write_array_index()`, the axis `hidden_axis` of the principal shape is ignored and
+// the previous element along `prev_axis` is accessed (used by accumulations)
+int64_t view_offset(const bh_view &view, const BhIntVec &coord, int hidden_axis = BH_MAXDIM,
+                    int prev_axis = BH_MAXDIM) {
+    int64_t ret = view.start;
+    if (not view.is_scalar()) { // NB: this is required when reducing a vector to a scalar!
+        // NB: the bound on `t` is implied by `view.ndim` but it lets the compiler see that `coord` isn't overrun
+        for (int i = 0; i < view.ndim; ++i) {
+            const int t = i >= hidden_axis ? i + 1 : i;
+            if (t >= BH_MAXDIM) {
+                break;
+            }
+            int64_t c = coord[t];
+            if (t == prev_axis and c > 0) {
+                --c;
+            }
+            ret += c * view.stride[i];
+        }
+    }
+    return ret;
+}
+
+// Read element `offset` of `base` as a `T`
+template<typename T>
+T read_element(const bh_base &base, int64_t offset) {
+    const void *data = base.getDataPtr();
+    switch (base.dtype()) {
+        case bh_type::BOOL:
+            return static_cast<T>(static_cast<const bh_bool *>(data)[offset]);
+        case bh_type::INT8:
+            return static_cast<T>(static_cast<const bh_int8 *>(data)[offset]);
+        case bh_type::INT16:
+            return static_cast<T>(static_cast<const bh_int16 *>(data)[offset]);
+        case bh_type::INT32:
+            return static_cast<T>(static_cast<const bh_int32 *>(data)[offset]);
+        case bh_type::INT64:
+            return static_cast<T>(static_cast<const bh_int64 *>(data)[offset]);
+        case bh_type::UINT8:
+            return static_cast<T>(static_cast<const bh_uint8 *>(data)[offset]);
+        case bh_type::UINT16:
+            return static_cast<T>(static_cast<const bh_uint16 *>(data)[offset]);
+        case bh_type::UINT32:
+            return static_cast<T>(static_cast<const bh_uint32 *>(data)[offset]);
+        case bh_type::UINT64:
+            return static_cast<T>(static_cast<const bh_uint64 *>(data)[offset]);
+        case bh_type::FLOAT32:
+            return static_cast<T>(static_cast<const bh_float32 *>(data)[offset]);
+        case bh_type::FLOAT64:
+            return static_cast<T>(static_cast<const bh_float64 *>(data)[offset]);
+        default:
+            throw runtime_error("interpreter: unsupported data type");
+    }
+}
+
+// Write `value` to element `offset` of `base`
+template<typename T>
+void write_element(bh_base &base, int64_t offset, T value) {
+    void *data = base.getDataPtr();
+    switch (base.dtype()) {
+        case bh_type::BOOL:
+            static_cast<bh_bool *>(data)[offset] = static_cast<bh_bool>(value != 0);
+            return;
+        case bh_type::INT8:
+            static_cast<bh_int8 *>(data)[offset] = static_cast<bh_int8>(value);
+            return;
+        case bh_type::INT16:
+            static_cast<bh_int16 *>(data)[offset] = static_cast<bh_int16>(value);
+            return;
+        case bh_type::INT32:
+            static_cast<bh_int32 *>(data)[offset] = static_cast<bh_int32>(value);
+            return;
+        case bh_type::INT64:
+            static_cast<bh_int64 *>(data)[offset] = static_cast<bh_int64>(value);
+            return;
+        case bh_type::UINT8:
+            static_cast<bh_uint8 *>(data)[offset] = static_cast<bh_uint8>(value);
+            return;
+        case bh_type::UINT16:
+            static_cast<bh_uint16 *>(data)[offset] = static_cast<bh_uint16>(value);
+            return;
+        case bh_type::UINT32:
+            static_cast<bh_uint32 *>(data)[offset] = static_cast<bh_uint32>(value);
+            return;
+        case bh_type::UINT64:
+            static_cast<bh_uint64 *>(data)[offset] = static_cast<bh_uint64>(value);
+            return;
+        case bh_type::FLOAT32:
+            static_cast<bh_float32 *>(data)[offset] = static_cast<bh_float32>(value);
+            return;
+        case bh_type::FLOAT64:
+            static_cast<bh_float64 *>(data)[offset] = static_cast<bh_float64>(value);
+            return;
+        default:
+            throw runtime_error("interpreter: unsupported data type");
+    }
+}
+
+// Read the value of the constant in `instr`
+template<typename T>
+T read_constant(const bh_instruction &instr);
+
+template<>
+double read_constant<double>(const bh_instruction &instr) {
+    return instr.constant.get_double();
+}
+
+template<>
+int64_t read_constant<int64_t>(const bh_instruction &instr) {
+    if (instr.constant.type == bh_type::UINT64) {
+        return static_cast<int64_t>(instr.constant.get_uint64());
+    }
+    return instr.constant.get_int64();
+}
+
+template<>
+uint64_t read_constant<uint64_t>(const bh_instruction &instr) {
+    if (instr.constant.type == bh_type::UINT64) {
+        return instr.constant.get_uint64();
+    }
+    return static_cast<uint64_t>(instr.constant.get_int64());
+}
+
+// The absolute value of `a`, which is the identity for unsigned types
+template<typename T>
+T absolute(T a) {
+    return std::abs(a);
+}
+
+template<>
+uint64_t absolute<uint64_t>(uint64_t a) {
+    return a;
+}
+
+// Read operand number `o` of `instr` at the coordinate `coord`
+template<typename T>
+T read_operand(const bh_instruction &instr, size_t o, const BhIntVec &coord) {
+    const bh_view &view = instr.operand[o];
+    if (view.isConstant()) {
+        return read_constant<T>(instr);
+    }
+    return read_element<T>(*view.base, view_offset(view, coord));
+}
+
+// Apply `opcode` on `a` and `b` (unary opcodes ignore `b`). This matches `jitk::write_operation()`.
+template<typename T>
+T apply(bh_opcode opcode, T a, T b) {
+    switch (opcode) {
+        case BH_IDENTITY:
+            return a;
+        case BH_ADD:
+        case BH_ADD_REDUCE:
+        case BH_ADD_ACCUMULATE:
+            return a + b;
+        case BH_SUBTRACT:
+            return a - b;
+        case BH_MULTIPLY:
+        case BH_MULTIPLY_REDUCE:
+        case BH_MULTIPLY_ACCUMULATE:
+            return a * b;
+        case BH_DIVIDE:
+            return a / b;
+        case BH_MAXIMUM:
+        case BH_MAXIMUM_REDUCE:
+            return a > b ? a : b;
+        case BH_MINIMUM:
+        case BH_MINIMUM_REDUCE:
+            return a < b ? a : b;
+        case BH_GREATER:
+            return a > b;
+        case BH_GREATER_EQUAL:
+            return a >= b;
+        case BH_LESS:
+            return a < b;
+        case BH_LESS_EQUAL:
+            return a <= b;
+        case BH_EQUAL:
+            return a == b;
+        case BH_NOT_EQUAL:
+            return a != b;
+        case BH_LOGICAL_AND:
+        case BH_LOGICAL_AND_REDUCE:
+            return a && b;
+        case BH_LOGICAL_OR:
+        case BH_LOGICAL_OR_REDUCE:
+            return a || b;
+        case BH_LOGICAL_XOR:
+            return !a != !b;
+        case BH_LOGICAL_NOT:
+            return !a;
+        case BH_ABSOLUTE:
+            return absolute(a);
+        case BH_SQRT:
+            return static_cast<T>(std::sqrt(a));
+        case BH_EXP:
+            return static_cast<T>(std::exp(a));
+        case BH_LOG:
+            return static_cast<T>(std::log(a));
+        case BH_SIN:
+            return static_cast<T>(std::sin(a));
+        case BH_COS:
+            return static_cast<T>(std::cos(a));
+        default:
+            throw runtime_error("interpreter: unsupported opcode");
+    }
+}
+
+// Execute `instr` using `T` as the arithmetic type
+template<typename T>
+void interpret_instr(const bh_instruction &instr) {
+    const BhIntVec shape = instr.shape();
+    const int sweep_axis = instr.sweep_axis();
+    const bool reduction = bh_opcode_is_reduction(instr.opcode);
+    const bool accumulate = bh_opcode_is_accumulate(instr.opcode);
+    const bool binary = instr.operand.size() == 3 and not bh_opcode_is_sweep(instr.opcode);
+    const bh_view &out = instr.operand[0];
+    const int64_t nelem = shape.prod();
+
+    BhIntVec coord(shape.size(), 0);
+    for (int64_t n = 0; n < nelem; ++n) {
+        const int64_t out_offset = view_offset(out, coord, reduction ? sweep_axis : BH_MAXDIM);
+        T result;
+        if (instr.opcode == BH_RANGE) {
+            // NB: like the compiled kernels, the range is the flat index of the iteration, which is only
+            //     the memory offset when the output is contiguous
+            result = static_cast<T>(n);
+        } else if (reduction) {
+            result = apply<T>(instr.opcode, read_element<T>(*out.base, out_offset),
+                              read_operand<T>(instr, 1, coord));
+        } else if (accumulate) {
+            // NB: the first element along the sweep axis reads itself, which the identity instruction initiated
+            const T prev = read_element<T>(*out.base, view_offset(out, coord, BH_MAXDIM, sweep_axis));
+            result = apply<T>(instr.opcode, prev, read_operand<T>(instr, 1, coord));
+        } else if (binary) {
+            result = apply<T>(instr.opcode, read_operand<T>(instr, 1, coord), read_operand<T>(instr, 2, coord));
+        } else {
+            const T a = read_operand<T>(instr, 1, coord);
+            result = apply<T>(instr.opcode, a, a);
+        }
+        write_element<T>(*out.base, out_offset, result);
+
+        // Increment the coordinate in row-major order
+        for (int64_t d = static_cast<int64_t>(coord.size()) - 1; d >= 0; --d) {
+            if (++coord[d] < shape[d]) {
+                break;
+            }
+            coord[d] = 0;
+        }
+    }
+}
+} // Anon namespace
+
+bool interpreter_compatible(const jitk::LoopB &kernel) {
+    for (const jitk::InstrPtr &instr: jitk::iterator::allInstr(kernel)) {
+        if (bh_opcode_is_system(instr->opcode)) {
+            continue;
+        }
+        if (not opcode_supported(*instr)) {
+            return false;
+        }
+        for (size_t i = 0; i < instr->operand.size(); ++i) {
+            const bh_view &view = instr->operand[i];
+            const bh_type type = instr->operand_type(static_cast<int>(i));
+            if (view.hasSlide() or not type_supported(type)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void interpret(const jitk::LoopB &kernel) {
+    // Since we execute one instruction at a time, temporary arrays are also materialized
+    for (const jitk::InstrPtr &instr: jitk::iterator::allInstr(kernel)) {
+        for (const bh_view &view: instr->getViews()) {
+            bh_data_malloc(view.base);
+        }
+    }
+
+    for (const jitk::InstrPtr &instr: jitk::iterator::allInstr(kernel)) {
+        if (bh_opcode_is_system(instr->opcode)) {
+            continue;
+        }
+        switch (arith_type(*instr)) {
+            case ArithType::FLOAT64:
+                interpret_instr<double>(*instr);
+                break;
+            case ArithType::UINT64:
+                interpret_instr<uint64_t>(*instr);
+                break;
+            default:
+                interpret_instr<int64_t>(*instr);
+        }
+    }
+}
+
+} // bohrium
@@ -0,0 +1,37 @@
+/*
+This file is part of Bohrium and copyright (c) 2012 the Bohrium
+team <http://www.bh107.org>.
+
+Bohrium is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as
+published by the Free Software Foundation, either version 3
+of the License, or (at your option) any later version.
+
+Bohrium is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the
+GNU Lesser General Public License along with Bohrium.
+
+If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <bohrium/jitk/block.hpp>
+
+namespace bohrium {
+
+/** A simple interpreter that executes a kernel one instruction at a time without any JIT-compilation.
+ *  It is used as a fallback while the JIT-compiled version of the kernel is being built in the background.
+ *  NB: the interpreter is slow and only supports a subset of the opcodes and data types (no complex types).
+ */
+
+/// Return true when all instructions in `kernel` are supported by the interpreter
+bool interpreter_compatible(const jitk::LoopB &kernel);
+
+/// Execute `kernel` using the interpreter, which makes sure that all involved arrays are allocated
+void interpret(const jitk::LoopB &kernel);
+
+} // bohrium
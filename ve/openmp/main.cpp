@@ -81,6 +81,9 @@ public:
             return ss.str();
         } else if (msg == "info") {
             ss << engine.info();
+        } else if (msg == "fuse_cache_stat") {
+            // NB: the bridge sums the "<lookups> <misses>" pairs of all engines in the stack
+            ss << stat.fuser_cache_lookups << " " << stat.fuser_cache_misses << " ";
         }
         return ss.str();
     }
@@ -93,6 +96,7 @@ public:
         if (force_alloc) {
             bh_data_malloc(&base);
         }
+        bh_spill_prepare({&base}); // A spilled array is faulted back in
         void *ret = base.getDataPtr();
         if (nullify) {
             base.resetDataPtr();
@@ -19,9 +19,14 @@ If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <sstream>
+#include <cstdlib>
+#include <map>
+#include <set>
 #include <bohrium/bh_opcode.h>
 #include <bohrium/jitk/symbol_table.hpp>
 #include <bohrium/jitk/iterator.hpp>
+#include <bohrium/jitk/scope.hpp>
 
 // Return the OpenMP reduction symbol
 const char* openmp_reduce_symbol(bh_opcode opcode) {
@@ -40,6 +45,12 @@ const char* openmp_reduce_symbol(bh_opcode opcode) {
             return "max";
         case BH_MINIMUM_REDUCE:
             return "min";
+        case BH_LOGICAL_AND_REDUCE:
+            return "&&";
+        case BH_LOGICAL_OR_REDUCE:
+            return "||";
+        case BH_LOGICAL_XOR_REDUCE: // NB: the logical reductions only support booleans
+            return "^";
         default:
             return NULL;
     }
@@ -92,3 +103,200 @@ bool openmp_atomic_compatible(bh_opcode opcode) {
             return false;
     }
 }
+
+// Is 'base' accessed by any other instruction in 'block' than 'instr'
+bool accessed_by_others(const bohrium::jitk::LoopB &block, const bohrium::jitk::InstrPtr &instr, const bh_base *base) {
+    for (const bohrium::jitk::InstrPtr &other: bohrium::jitk::iterator::allInstr(block)) {
+        if (other != instr) {
+            for (const bh_view &view: other->getViews()) {
+                if (view.base == base) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/* Is the reduction 'instr' in 'block' compatible with an OpenMP array section reduction such as
+ * reduction(+:a1[lo:len]), which gives each thread a private copy of the output array.
+ * Thus, the output must be small and no other instruction in 'block' may access it.
+ */
+bool openmp_array_section_compatible(const bohrium::jitk::LoopB &block,
+                                     const bohrium::jitk::InstrPtr &instr,
+                                     const bohrium::jitk::Scope &scope) {
+    const bh_view &view = instr->operand[0];
+    return openmp_reduce_compatible(instr->opcode) and scope.isArray(view) and
+           bohrium::jitk::array_section_span(view) <= bohrium::jitk::ARRAY_SECTION_MAX_SPAN and
+           not accessed_by_others(block, instr, view.base);
+}
+
+// Write the OpenMP array section (e.g. `a1[lo:len]`) that covers all elements of 'view'
+void write_openmp_array_section(const bohrium::jitk::Scope &scope, const bh_view &view, std::stringstream &out) {
+    scope.getName(view, out);
+    out << "[";
+    if (scope.symbols.strides_as_var and scope.symbols.existOffsetStridesID(view)) {
+        // NB: the strides are only known at runtime thus we handle negative strides in the generated code
+        const size_t id = scope.symbols.offsetStridesID(view);
+        out << "vo" << id;
+        for (int i = 0; i < view.ndim; ++i) {
+            if (view.shape[i] > 1) {
+                out << " + ((int64_t)vs" << id << "_" << i << " < 0 ? ";
+                out << view.shape[i] - 1 << " * (int64_t)vs" << id << "_" << i << " : 0)";
+            }
+        }
+        out << " : 1";
+        for (int i = 0; i < view.ndim; ++i) {
+            if (view.shape[i] > 1) {
+                out << " + " << view.shape[i] - 1 << " * ((int64_t)vs" << id << "_" << i << " < 0 ? ";
+                out << "-(int64_t)vs" << id << "_" << i << " : (int64_t)vs" << id << "_" << i << ")";
+            }
+        }
+    } else {
+        int64_t lo = view.start;
+        for (int i = 0; i < view.ndim; ++i) {
+            if (view.stride[i] < 0) {
+                lo += (view.shape[i] - 1) * view.stride[i];
+            }
+        }
+        out << lo << ":" << bohrium::jitk::array_section_span(view);
+    }
+    out << "]";
+}
+
+// Return the associative operator of the accumulate 'opcode' or NULL if the accumulate cannot be parallelized
+const char* parallel_scan_symbol(bh_opcode opcode) {
+    switch (opcode) {
+        case BH_ADD_ACCUMULATE:
+            return "+";
+        case BH_MULTIPLY_ACCUMULATE:
+            return "*";
+        default:
+            return NULL;
+    }
+}
+
+/* Is the 'block' compatible with a parallel prefix scan: a one-dimensional loop where all sweeps are accumulates
+ * that have an associative operator and no other instruction in the loop accesses their output.
+ */
+bool parallel_scan_compatible(const bohrium::jitk::LoopB &block, const bohrium::jitk::Scope &scope) {
+    if (block.rank != 0 or not block.isInnermost() or block._sweeps.empty()) {
+        return false;
+    }
+    for (const bohrium::jitk::InstrPtr &instr: block._sweeps) {
+        const bh_view &view = instr->operand[0];
+        if (parallel_scan_symbol(instr->opcode) == NULL or instr->sweep_axis() != 0 or view.ndim != 1 or
+            not scope.isArray(view) or instr->operand[1].base == view.base or
+            accessed_by_others(block, instr, view.base)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Return the GCC vector extension operator of the elementwise 'opcode' on elements of type 'dtype'
+// or NULL if the vector code doesn't support 'opcode'
+const char* vector_operator(bh_opcode opcode, bh_type dtype) {
+    const bool is_float = dtype == bh_type::FLOAT32 or dtype == bh_type::FLOAT64;
+    switch (opcode) {
+        case BH_ADD:
+            return "+";
+        case BH_SUBTRACT:
+            return "-";
+        case BH_MULTIPLY:
+            return "*";
+        case BH_DIVIDE: // NB: integer division must follow Python
+            return is_float ? "/" : NULL;
+        case BH_BITWISE_AND:
+            return is_float ? NULL : "&";
+        case BH_BITWISE_OR:
+            return is_float ? NULL : "|";
+        case BH_BITWISE_XOR:
+            return is_float ? NULL : "^";
+        default:
+            return NULL;
+    }
+}
+
+// Does the vector code support elements of type 'dtype'
+bool vector_dtype_compatible(bh_type dtype) {
+    switch (dtype) {
+        case bh_type::INT8:
+        case bh_type::INT16:
+        case bh_type::INT32:
+        case bh_type::INT64:
+        case bh_type::UINT8:
+        case bh_type::UINT16:
+        case bh_type::UINT32:
+        case bh_type::UINT64:
+        case bh_type::FLOAT32:
+        case bh_type::FLOAT64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Is the 'block' compatible with explicit vector code: an innermost loop without sweeps where all instructions
+ * are identities or have a vector operator, all operands have the same data type (written to 'dtype'), and each
+ * array is accessed through one view, which must be contiguous along the loop when the strides are hard-coded.
+ */
+bool vector_compatible(const bohrium::jitk::LoopB &block, const bohrium::jitk::Scope &scope, bh_type &dtype) {
+    if (block.rank < 0 or not block.isInnermost() or not block._sweeps.empty()) {
+        return false;
+    }
+    const std::set<bh_base *> local_tmps = block.getLocalTemps();
+    std::map<const bh_base *, bh_view> array_views;
+    bool first = true;
+    for (const bohrium::jitk::InstrPtr &instr: bohrium::jitk::iterator::allLocalInstr(block)) {
+        if (bh_opcode_is_system(instr->opcode)) {
+            continue;
+        }
+        if (first) {
+            dtype = instr->operand[0].base->dtype();
+            first = false;
+        }
+        if (not vector_dtype_compatible(dtype)) {
+            return false;
+        }
+        if (not ((instr->opcode == BH_IDENTITY and instr->operand.size() == 2) or
+                 (vector_operator(instr->opcode, dtype) != NULL and instr->operand.size() == 3))) {
+            return false;
+        }
+        for (size_t o = 0; o < instr->operand.size(); ++o) {
+            const bh_view &view = instr->operand[o];
+            if (view.isConstant()) {
+                if (instr->constant.type != dtype) {
+                    return false;
+                }
+                continue;
+            }
+            if (view.base->dtype() != dtype) {
+                return false;
+            }
+            if (scope.isDeclared(view)) { // Declared by a parent thus broadcasted to all lanes
+                if (o == 0) {
+                    return false;
+                }
+            } else if (not (util::exist(local_tmps, view.base) and
+                            not scope.symbols.isAlwaysArray(view.base))) {
+                auto it = array_views.find(view.base);
+                if (it != array_views.end() and it->second != view) {
+                    return false;
+                }
+                array_views.insert(std::make_pair(view.base, view));
+                if (view.is_scalar()) { // A single element is broadcasted to all lanes
+                    if (o == 0) {
+                        return false;
+                    }
+                } else if (view.ndim != block.rank + 1) {
+                    return false;
+                } else if (not (scope.symbols.strides_as_var and scope.symbols.existOffsetStridesID(view)) and
+                           view.stride[block.rank] != 1) {
+                    return false;
+                }
+            }
+        }
+    }
+    return not first;
+}